@@ -326,6 +326,27 @@ void deleteValueObject(ValueObject *value)
 	}
 }
 
+/**
+ * Hashes a scope value name.
+ *
+ * Scopes store the hash of each value name alongside the name itself so that
+ * lookups may skip most string comparisons; two names are only compared
+ * character-by-character when their hashes collide.
+ *
+ * \param [in] name The name to hash.
+ *
+ * \return The hash of \a name.
+ */
+static unsigned long hashScopeName(const char *name)
+{
+	unsigned long hash = 2166136261UL;
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
 /**
  * Creates a scope.
  *
@@ -352,6 +373,7 @@ ScopeObject *createScopeObject(ScopeObject *parent)
 	}
 	p->numvals = 0;
 	p->names = NULL;
+	p->hashes = NULL;
 	p->values = NULL;
 	p->parent = parent;
 	if (parent) p->caller = parent->caller;
@@ -395,6 +417,7 @@ void deleteScopeObject(ScopeObject *scope)
 		deleteValueObject(scope->values[n]);
 	}
 	free(scope->names);
+	free(scope->hashes);
 	free(scope->values);
 	deleteValueObject(scope->impvar);
 	free(scope);
@@ -423,6 +446,7 @@ ValueObject *createScopeValue(ScopeObject *src,
 	unsigned int newnumvals;
 	void *mem1 = NULL;
 	void *mem2 = NULL;
+	void *mem3 = NULL;
 	char *name = NULL;
 
 	/* Traverse the target to the terminal child and parent */
@@ -447,10 +471,17 @@ ValueObject *createScopeValue(ScopeObject *src,
 		perror("realloc");
 		goto createScopeValueAbort;
 	}
+	mem3 = realloc(dest->hashes, sizeof(unsigned long) * newnumvals);
+	if (!mem3) {
+		perror("realloc");
+		goto createScopeValueAbort;
+	}
 
 	dest->names = mem1;
 	dest->values = mem2;
+	dest->hashes = mem3;
 	dest->names[dest->numvals] = name;
+	dest->hashes[dest->numvals] = hashScopeName(name);
 	dest->values[dest->numvals] = createNilValueObject();
 	if (!dest->values[dest->numvals]) goto createScopeValueAbort;
 	dest->numvals = newnumvals;
@@ -463,6 +494,7 @@ createScopeValueAbort: /* In case something goes wrong... */
 	if (name) free(name);
 	if (mem1) free(mem1);
 	if (mem2) free(mem2);
+	if (mem3) free(mem3);
 
 	return NULL;
 }
@@ -492,6 +524,7 @@ ValueObject *updateScopeValue(ScopeObject *src,
 	IdentifierNode *child = target;
 	int status;
 	char *name = NULL;
+	unsigned long hash;
 
 	/* Traverse the target to the terminal child and parent */
 	status = resolveTerminalSlot(src, dest, target, &parent, &child);
@@ -500,13 +533,14 @@ ValueObject *updateScopeValue(ScopeObject *src,
 	/* Look up the identifier name */
 	name = resolveIdentifierName(child, src);
 	if (!name) goto updateScopeValueAbort;
+	hash = hashScopeName(name);
 
 	/* Traverse upwards through scopes */
 	do {
 		unsigned int n;
 		/* Check for existing value in current scope */
 		for (n = 0; n < parent->numvals; n++) {
-			if (!strcmp(parent->names[n], name)) {
+			if (parent->hashes[n] == hash && !strcmp(parent->names[n], name)) {
 				free(name);
 				/* Wipe out the old value */
 				deleteValueObject(parent->values[n]);
@@ -557,6 +591,7 @@ ValueObject *getScopeValue(ScopeObject *src,
 	ScopeObject *parent = dest;
 	IdentifierNode *child = target;
 	char *name = NULL;
+	unsigned long hash;
 	int status;
 
 	/* Traverse the target to the terminal child and parent */
@@ -566,13 +601,14 @@ ValueObject *getScopeValue(ScopeObject *src,
 	/* Look up the identifier name */
 	name = resolveIdentifierName(child, src);
 	if (!name) goto getScopeValueAbort;
+	hash = hashScopeName(name);
 
 	/* Traverse upwards through scopes */
 	do {
 		unsigned int n;
 		/* Check for value in current scope */
 		for (n = 0; n < parent->numvals; n++) {
-			if (!strcmp(parent->names[n], name)) {
+			if (parent->hashes[n] == hash && !strcmp(parent->names[n], name)) {
 				free(name);
 				return parent->values[n];
 			}
@@ -615,10 +651,12 @@ ScopeObject *getScopeObjectLocal(ScopeObject *src,
 {
 	ScopeObject *current = dest;
 	char *name = NULL;
+	unsigned long hash;
 
 	/* Look up the identifier name */
 	name = resolveIdentifierName(target, src);
 	if (!name) goto getScopeObjectLocalAbort;
+	hash = hashScopeName(name);
 
 	/* Check for calling object reference variable */
 	if (!strcmp(name, "ME")) {
@@ -635,7 +673,7 @@ ScopeObject *getScopeObjectLocal(ScopeObject *src,
 		unsigned int n;
 		/* Check for value in current scope */
 		for (n = 0; n < current->numvals; n++) {
-			if (!strcmp(current->names[n], name)) {
+			if (current->hashes[n] == hash && !strcmp(current->names[n], name)) {
 				if (current->values[n]->type != VT_ARRAY) {
 					error(IN_VARIABLE_NOT_AN_ARRAY, target->fname, target->line, name);
 					goto getScopeObjectLocalAbort;
@@ -682,10 +720,12 @@ ScopeObject *getScopeObjectLocalCaller(ScopeObject *src,
 {
 	ScopeObject *current = dest;
 	char *name = NULL;
+	unsigned long hash;
 
 	/* Look up the identifier name */
 	name = resolveIdentifierName(target, src);
 	if (!name) goto getScopeObjectLocalCallerAbort;
+	hash = hashScopeName(name);
 
 	/* Check for calling object reference variable */
 	if (!strcmp(name, "ME")) {
@@ -702,7 +742,7 @@ ScopeObject *getScopeObjectLocalCaller(ScopeObject *src,
 		unsigned int n;
 		/* Check for value in current scope */
 		for (n = 0; n < current->numvals; n++) {
-			if (!strcmp(current->names[n], name)) {
+			if (current->hashes[n] == hash && !strcmp(current->names[n], name)) {
 				if (current->values[n]->type != VT_ARRAY
 						&& current->values[n]->type != VT_FUNC) {
 					error(IN_VARIABLE_NOT_AN_ARRAY, target->fname, target->line, name);
@@ -756,6 +796,7 @@ ValueObject *getScopeValueLocal(ScopeObject *src,
 {
 	unsigned int n;
 	char *name = NULL;
+	unsigned long hash;
 	ScopeObject *scope = NULL;
 
 	/* Access any slots */
@@ -774,10 +815,11 @@ ValueObject *getScopeValueLocal(ScopeObject *src,
 	/* Look up the identifier name */
 	name = resolveIdentifierName(target, src);
 	if (!name) goto getScopeValueLocalAbort;
+	hash = hashScopeName(name);
 
 	/* Check for value in current scope */
 	for (n = 0; n < dest->numvals; n++) {
-		if (!strcmp(dest->names[n], name)) {
+		if (dest->hashes[n] == hash && !strcmp(dest->names[n], name)) {
 			free(name);
 			return dest->values[n];
 		}
@@ -885,8 +927,10 @@ void deleteScopeValue(ScopeObject *src,
 {
 	ScopeObject *current = NULL;
 	char *name = NULL;
+	unsigned long hash;
 	void *mem1 = NULL;
 	void *mem2 = NULL;
+	void *mem3 = NULL;
 	ScopeObject *scope = NULL;
 
 	/* Access any slots */
@@ -905,13 +949,14 @@ void deleteScopeValue(ScopeObject *src,
 	/* Look up the identifier name */
 	name = resolveIdentifierName(target, src);
 	if (!name) goto deleteScopeValueAbort;
+	hash = hashScopeName(name);
 
 	/* Traverse upwards through scopes */
 	do {
 		unsigned int n;
 		/* Check for existing value in current scope */
 		for (n = 0; n < current->numvals; n++) {
-			if (!strcmp(current->names[n], name)) {
+			if (current->hashes[n] == hash && !strcmp(current->names[n], name)) {
 				unsigned int i;
 				unsigned int newnumvals = dest->numvals - 1;
 				free(name);
@@ -921,6 +966,7 @@ void deleteScopeValue(ScopeObject *src,
 				/* Reorder the tables */
 				for (i = n; i < current->numvals - 1; i++) {
 					current->names[i] = current->names[i + 1];
+					current->hashes[i] = current->hashes[i + 1];
 					current->values[i] = current->values[i + 1];
 				}
 				/* Resize the tables */
@@ -934,8 +980,14 @@ void deleteScopeValue(ScopeObject *src,
 					perror("realloc");
 					goto deleteScopeValueAbort;
 				}
+				mem3 = realloc(dest->hashes, sizeof(unsigned long) * newnumvals);
+				if (!mem3) {
+					perror("realloc");
+					goto deleteScopeValueAbort;
+				}
 				dest->names = mem1;
 				dest->values = mem2;
+				dest->hashes = mem3;
 				dest->numvals = newnumvals;
 				return;
 			}
@@ -1497,7 +1549,7 @@ ValueObject *castStringExplicit(ValueObject *node,
 					a += num, b += len + 3;
 				}
 				else if (!strncmp(str + b, ":{", 2)) {
-					IdentifierNode *target = NULL;
+					IdentifierNode target;
 					ValueObject *val = NULL, *use = NULL;
 					/* Copy the variable name into image */
 					const char *start = str + b + 2;
@@ -1519,23 +1571,23 @@ ValueObject *castStringExplicit(ValueObject *node,
 						val = scope->impvar;
 					else {
 						/*
-						 * Create a new IdentifierNode
-						 * structure and look up its
-						 * value
+						 * Look up the variable's value
+						 * through a temporary
+						 * identifier
 						 */
-						target = createIdentifierNode(IT_DIRECT, image, NULL, NULL, 0);
-						if (!target) {
-							free(temp);
-							return NULL;
-						}
-						val = getScopeValue(scope, scope, target);
+						target.type = IT_DIRECT;
+						target.id = image;
+						target.slot = NULL;
+						target.fname = NULL;
+						target.line = 0;
+						val = getScopeValue(scope, scope, &target);
 						if (!val) {
-							error(IN_VARIABLE_DOES_NOT_EXIST, target->fname, target->line, image);
-							deleteIdentifierNode(target);
+							error(IN_VARIABLE_DOES_NOT_EXIST, target.fname, target.line, image);
+							free(image);
 							free(temp);
 							return NULL;
 						}
-						deleteIdentifierNode(target);
+						free(image);
 					}
 					/* Cast the variable value to a string */
 					if (!(use = castStringImplicit(val, scope))) {
@@ -1615,11 +1667,11 @@ ValueObject *interpretImpVarExprNode(ExprNode *node,
 ValueObject *interpretCastExprNode(ExprNode *node,
                                    ScopeObject *scope)
 {
-	CastExprNode *expr = (CastExprNode *)node->expr;
+	CastExprNode *expr = (CastExprNode *)getExprData(node);
 	ValueObject *val = interpretExprNode(expr->target, scope);
 	ValueObject *ret = NULL;
 	if (!val) return NULL;
-	switch(expr->newtype->type) {
+	switch(expr->newtype.type) {
 		case CT_NIL:
 			deleteValueObject(val);
 			return createNilValueObject();
@@ -1662,7 +1714,7 @@ ValueObject *interpretCastExprNode(ExprNode *node,
 ValueObject *interpretFuncCallExprNode(ExprNode *node,
                                        ScopeObject *scope)
 {
-	FuncCallExprNode *expr = (FuncCallExprNode *)node->expr;
+	FuncCallExprNode *expr = (FuncCallExprNode *)getExprData(node);
 	unsigned int n;
 	ScopeObject *outer = NULL;
 	ValueObject *def = NULL;
@@ -1766,7 +1818,7 @@ ValueObject *interpretFuncCallExprNode(ExprNode *node,
 ValueObject *interpretIdentifierExprNode(ExprNode *node,
                                          ScopeObject *scope)
 {
-	ValueObject *val = getScopeValue(scope, scope, node->expr);
+	ValueObject *val = getScopeValue(scope, scope, getExprData(node));
 	if (!val) return NULL;
 	return copyValueObject(val);
 }
@@ -1792,7 +1844,7 @@ ValueObject *interpretIdentifierExprNode(ExprNode *node,
 ValueObject *interpretConstantExprNode(ExprNode *node,
                                        ScopeObject *scope)
 {
-	ConstantNode *expr = (ConstantNode *)node->expr;
+	ConstantNode *expr = (ConstantNode *)getExprData(node);
 	scope = NULL;
 	switch (expr->type) {
 		case CT_NIL:
@@ -2902,7 +2954,7 @@ static ValueObject *(*OpExprJumpTable[14])(OpExprNode *, ScopeObject *) = {
 ValueObject *interpretOpExprNode(ExprNode *node,
                                  ScopeObject *scope)
 {
-	OpExprNode *expr = (OpExprNode *)node->expr;
+	OpExprNode *expr = (OpExprNode *)getExprData(node);
 	return OpExprJumpTable[expr->type](expr, scope);
 }
 
@@ -2932,7 +2984,7 @@ static ValueObject *(*ExprJumpTable[6])(ExprNode *, ScopeObject *) = {
 ValueObject *interpretExprNode(ExprNode *node,
                                ScopeObject *scope)
 {
-	return ExprJumpTable[node->type](node, scope);
+	return ExprJumpTable[getExprType(node)](node, scope);
 }
 
 /**
@@ -2963,7 +3015,7 @@ ReturnObject *interpretCastStmtNode(StmtNode *node,
 		}
 		return NULL;
 	}
-	switch(stmt->newtype->type) {
+	switch(stmt->newtype.type) {
 		case CT_NIL:
 			if (!(cast = createNilValueObject())) return NULL;
 			break;
@@ -3464,6 +3516,8 @@ ReturnObject *interpretLoopStmtNode(StmtNode *node,
 			guardval = getInteger(use);
 			if (cast) deleteValueObject(use);
 			deleteValueObject(val);
+			/* A TIL loop runs until its guard becomes true */
+			if (stmt->invert) guardval = !guardval;
 			if (guardval == 0) break;
 		}
 		if (stmt->body) {
@@ -3490,10 +3544,10 @@ ReturnObject *interpretLoopStmtNode(StmtNode *node,
 			 * structure, just go ahead and do it to the loop
 			 * variable.
 			 */
-			if (stmt->update->type == ET_OP) {
+			if (getExprType(stmt->update) == ET_OP) {
 				ValueObject *updated = NULL;
 				var = getScopeValue(scope, outer, stmt->var);
-				OpExprNode *op = (OpExprNode *)stmt->update->expr;
+				OpExprNode *op = (OpExprNode *)getExprData(stmt->update);
 				if (op->type == OP_ADD)
 					updated = createIntegerValueObject(var->data.i + 1);
 				else if (op->type == OP_SUB)
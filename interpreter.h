@@ -115,6 +115,7 @@ typedef struct scopeobject {
 	ValueObject *impvar;        /**< The \ref impvar "implicit variable". */
 	unsigned int numvals;       /**< The number of values in the scope. */
 	char **names;               /**< The names of the values. */
+	unsigned long *hashes;      /**< The hashes of the names of the values. */
 	ValueObject **values;       /**< The values in the scope. */
 } ScopeObject;
 
@@ -15,18 +15,26 @@
  */
 Lexeme *createLexeme(char *image, const char *fname, unsigned int line)
 {
+	size_t len = strlen(image);
 	Lexeme *ret = malloc(sizeof(Lexeme));
 	if (!ret) {
 		perror("malloc");
 		return NULL;
 	}
-	ret->image = malloc(sizeof(char) * (strlen(image) + 1));
+	ret->image = malloc(sizeof(char) * (len + 1));
 	if (!(ret->image)) {
 		free(ret);
 		perror("malloc");
 		return NULL;
 	}
-	strcpy(ret->image, image);
+	memcpy(ret->image, image, len + 1);
+	/* Remember the length so later passes need not rescan the image */
+	ret->len = len;
+	/* Classify line breaks and the end-of-file marker up front so the
+	 * tokenizer can dispatch on a byte instead of comparing images */
+	if (image[0] == '\n') ret->kind = LK_NEWLINE;
+	else if (image[0] == '$' && len == 1) ret->kind = LK_EOF;
+	else ret->kind = LK_WORD;
 	/**
 	 * \note \a fname is not copied because it only one copy is stored for
 	 * all lexemes from the same file.  This is simply to avoid large
@@ -24,12 +24,25 @@
 
 #undef DEBUG
 
+/**
+ * Represents the kind of a lexeme.  The kind is determined once when the
+ * lexeme is created so that later passes can dispatch on a single byte
+ * instead of examining the image again.
+ */
+typedef enum {
+	LK_WORD,    /**< An ordinary lexeme. */
+	LK_NEWLINE, /**< A logical line break. */
+	LK_EOF      /**< The end-of-file marker. */
+} LexemeKind;
+
 /**
  * Stores a lexeme.  A lexeme is a group of contiguous characters, stripped of
  * surrounding whitespace or other lexemes.
  */
 typedef struct {
 	char *image;       /**< The string that identifies the lexeme. */
+	size_t len;        /**< The number of characters in \a image. */
+	LexemeKind kind;   /**< The kind of lexeme \a image holds. */
 	const char *fname; /**< The name of the file containing the lexeme. */
 	unsigned int line; /**< The line number the lexeme occurred on. */
 } Lexeme;
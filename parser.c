@@ -1,18 +1,219 @@
 #include "parser.h"
 
+/*
+ * Parse tracing helpers.  In release builds these expand to no-ops so that
+ * call sites need no conditional compilation and the parse functions stay
+ * straight-line code.
+ */
 #ifdef DEBUG
 static unsigned int shiftwidth = 0;
-void shiftout(void) { shiftwidth += 4; }
-void shiftin(void) { shiftwidth -= 4; }
-void debug(const char *info)
+static void shiftout(void) { shiftwidth += 4; }
+static void shiftin(void) { shiftwidth -= 4; }
+static void debug(const char *info)
 {
 	int n;
 	for (n = 0; n < shiftwidth; n++)
 		fprintf(stderr, " ");
 	fprintf(stderr, "%s\n", info);
 }
+#else
+#define shiftout() ((void)0)
+#define shiftin() ((void)0)
+#define debug(info) ((void)0)
 #endif
 
+/** The default number of usable bytes in an arena chunk. */
+#define ARENA_CHUNK_SIZE 16384
+
+/**
+ * Stores a chunk of parse tree memory.  All parse tree nodes, strings, and
+ * list arrays are bump-allocated out of a singly linked list of chunks and
+ * freed all at once when the parse tree is deleted (see deleteMainNode).
+ */
+typedef struct arenachunk {
+	struct arenachunk *next; /**< The previously filled chunk. */
+	size_t off;              /**< The offset of the first free byte. */
+	size_t cap;              /**< The number of usable bytes. */
+} ArenaChunk;
+
+/** The current (most recently allocated) parse tree arena chunk. */
+static ArenaChunk *parserArena = NULL;
+
+/**
+ * Allocates memory from the parser's arena.
+ *
+ * \param [in] size The number of bytes to allocate.
+ *
+ * \return A pointer to the allocated memory, which is valid until
+ * deleteArena() is called.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static void *arenaAlloc(size_t size)
+{
+	ArenaChunk *chunk = parserArena;
+	void *mem;
+	/* Keep all allocations 8-byte aligned: ExprNode stores its type in
+	 * the low bits of node addresses */
+	size = (size + 7) & ~(size_t)7;
+	if (!chunk || chunk->cap - chunk->off < size) {
+		size_t cap = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+		chunk = malloc(sizeof(ArenaChunk) + cap);
+		if (!chunk) {
+			perror("malloc");
+			return NULL;
+		}
+		chunk->next = parserArena;
+		chunk->off = 0;
+		chunk->cap = cap;
+		parserArena = chunk;
+	}
+	mem = (char *)(chunk + 1) + chunk->off;
+	chunk->off += size;
+	return mem;
+}
+
+/**
+ * Copies a string into the parser's arena.
+ *
+ * \param [in] str The string to copy.
+ *
+ * \return A pointer to the copied string.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static char *arenaStrdup(const char *str)
+{
+	size_t size = strlen(str) + 1;
+	char *copy = arenaAlloc(size);
+	if (copy) memcpy(copy, str, size);
+	return copy;
+}
+
+/**
+ * Stores the parser's string intern table.  Identifier names, file names,
+ * and string constants are deduplicated through this table so that equal
+ * strings share a single arena copy and can be compared by address.  The
+ * slot array lives on the heap and is released along with the arena (see
+ * deleteArena).
+ */
+typedef struct {
+	char **strings;   /**< The open-addressed slot array. */
+	unsigned int num; /**< The number of strings stored. */
+	unsigned int cap; /**< The number of slots (a power of two). */
+} InternTable;
+
+/** The parser's string intern table. */
+static InternTable parserInterns = { NULL, 0, 0 };
+
+/**
+ * The canonical constant integer "1" expression, shared by every increment
+ * and decrement loop lowering.  It lives in the parser's arena and so is
+ * reset along with it.
+ */
+static ExprNode *parserOneExpr = NULL;
+
+/**
+ * Hashes a string for the intern table.
+ *
+ * \param [in] str The string to hash.
+ *
+ * \return A hash of the contents of \a str.
+ */
+static unsigned int hashParserString(const char *str)
+{
+	/* 32-bit FNV-1a */
+	unsigned int hash = 2166136261u;
+	for (; *str; str++) {
+		hash ^= (unsigned char)*str;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Returns the canonical arena copy of a string.  Equal strings always return
+ * the same pointer, so interned strings can be compared by address.
+ *
+ * \param [in] str The string to intern.
+ *
+ * \return The canonical copy of \a str, valid until deleteArena() is
+ * called.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static char *internParserString(const char *str)
+{
+	unsigned int n;
+	char *copy;
+	/* Keep the table at most half full */
+	if ((parserInterns.num + 1) * 2 > parserInterns.cap) {
+		unsigned int newcap = parserInterns.cap ? parserInterns.cap * 2 : 256;
+		char **strings = calloc(newcap, sizeof(char *));
+		if (!strings) {
+			perror("calloc");
+			return NULL;
+		}
+		for (n = 0; n < parserInterns.cap; n++) {
+			unsigned int m;
+			if (!parserInterns.strings[n]) continue;
+			for (m = hashParserString(parserInterns.strings[n]) & (newcap - 1);
+					strings[m];
+					m = (m + 1) & (newcap - 1));
+			strings[m] = parserInterns.strings[n];
+		}
+		free(parserInterns.strings);
+		parserInterns.strings = strings;
+		parserInterns.cap = newcap;
+	}
+	for (n = hashParserString(str) & (parserInterns.cap - 1);
+			parserInterns.strings[n];
+			n = (n + 1) & (parserInterns.cap - 1)) {
+		if (!strcmp(parserInterns.strings[n], str))
+			return parserInterns.strings[n];
+	}
+	copy = arenaStrdup(str);
+	if (!copy) return NULL;
+	parserInterns.strings[n] = copy;
+	parserInterns.num++;
+	return copy;
+}
+
+/**
+ * Frees all of the memory allocated from the parser's arena, along with the
+ * intern table referencing it.
+ *
+ * \post Everything allocated by the parser since the previous call to this
+ * function will be freed.
+ */
+static void deleteArena(void)
+{
+	while (parserArena) {
+		ArenaChunk *next = parserArena->next;
+		free(parserArena);
+		parserArena = next;
+	}
+	free(parserInterns.strings);
+	parserInterns.strings = NULL;
+	parserInterns.num = 0;
+	parserInterns.cap = 0;
+	parserOneExpr = NULL;
+}
+
+/**
+ * Allocates a parse tree node from the parser's arena.
+ *
+ * \param [in] size The number of bytes to allocate.
+ *
+ * \return A pointer to the allocated node.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static void *allocNode(size_t size)
+{
+	return arenaAlloc(size);
+}
+
 /**
  * Creates the main code block of a program.
  *
@@ -24,11 +225,8 @@ void debug(const char *info)
  */
 MainNode *createMainNode(BlockNode *block)
 {
-	MainNode *p = malloc(sizeof(MainNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	MainNode *p = allocNode(sizeof(MainNode));
+	if (!p) return NULL;
 	p->block = block;
 	return p;
 }
@@ -38,13 +236,13 @@ MainNode *createMainNode(BlockNode *block)
  *
  * \param [in,out] node The main code block to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post The parse tree rooted at \a node and the arena backing it will be
+ * freed.
  */
 void deleteMainNode(MainNode *node)
 {
 	if (!node) return;
-	deleteBlockNode(node->block);
-	free(node);
+	deleteArena();
 }
 
 /**
@@ -58,11 +256,8 @@ void deleteMainNode(MainNode *node)
  */
 BlockNode *createBlockNode(StmtNodeList *stmts)
 {
-	BlockNode *p = malloc(sizeof(BlockNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	BlockNode *p = allocNode(sizeof(BlockNode));
+	if (!p) return NULL;
 	p->stmts = stmts;
 	return p;
 }
@@ -72,13 +267,12 @@ BlockNode *createBlockNode(StmtNodeList *stmts)
  *
  * \param [in,out] node The code block to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteBlockNode(BlockNode *node)
 {
-	if (!node) return;
-	deleteStmtNodeList(node->stmts);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -90,12 +284,10 @@ void deleteBlockNode(BlockNode *node)
  */
 BlockNodeList *createBlockNodeList(void)
 {
-	BlockNodeList *p = malloc(sizeof(BlockNodeList));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	BlockNodeList *p = allocNode(sizeof(BlockNodeList));
+	if (!p) return NULL;
 	p->num = 0;
+	p->cap = 0;
 	p->blocks = NULL;
 	return p;
 }
@@ -116,15 +308,21 @@ BlockNodeList *createBlockNodeList(void)
 int addBlockNode(BlockNodeList *list,
                  BlockNode *node)
 {
-	unsigned int newsize = list->num + 1;
-	void *mem = realloc(list->blocks, sizeof(BlockNode *) * newsize);
-	if (!mem) {
-		perror("realloc");
-		return 0;
+	if (list->num == list->cap) {
+		/* Grow geometrically, seeding enough room for a typical
+		 * switch statement; the old array is left behind in the arena
+		 * and freed with everything else */
+		unsigned int newcap = list->cap ? list->cap * 2 : 8;
+		BlockNode **mem = arenaAlloc(sizeof(BlockNode *) * newcap);
+		if (!mem) return 0;
+		/* The array pointer is NULL until the first growth */
+		if (list->num)
+			memcpy(mem, list->blocks, sizeof(BlockNode *) * list->num);
+		list->blocks = mem;
+		list->cap = newcap;
 	}
-	list->blocks = mem;
 	list->blocks[list->num] = node;
-	list->num = newsize;
+	list->num++;
 	return 1;
 }
 
@@ -133,16 +331,12 @@ int addBlockNode(BlockNodeList *list,
  *
  * \param [in,out] list The code block list to delete.
  *
- * \post The memory at \a list and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a list belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteBlockNodeList(BlockNodeList *list)
 {
-	unsigned int n;
-	if (!list) return;
-	for (n = 0; n < list->num; n++)
-		deleteBlockNode(list->blocks[n]);
-	free(list->blocks);
-	free(list);
+	(void)list;
 }
 
 /**
@@ -157,11 +351,8 @@ void deleteBlockNodeList(BlockNodeList *list)
  */
 ConstantNode *createBooleanConstantNode(int data)
 {
-	ConstantNode *p = malloc(sizeof(ConstantNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	ConstantNode *p = allocNode(sizeof(ConstantNode));
+	if (!p) return NULL;
 	p->type = CT_BOOLEAN;
 	p->data.i = (data != 0);
 	return p;
@@ -178,11 +369,8 @@ ConstantNode *createBooleanConstantNode(int data)
  */
 ConstantNode *createIntegerConstantNode(long long data)
 {
-	ConstantNode *p = malloc(sizeof(ConstantNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	ConstantNode *p = allocNode(sizeof(ConstantNode));
+	if (!p) return NULL;
 	p->type = CT_INTEGER;
 	p->data.i = data;
 	return p;
@@ -199,11 +387,8 @@ ConstantNode *createIntegerConstantNode(long long data)
  */
 ConstantNode *createFloatConstantNode(float data)
 {
-	ConstantNode *p = malloc(sizeof(ConstantNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	ConstantNode *p = allocNode(sizeof(ConstantNode));
+	if (!p) return NULL;
 	p->type = CT_FLOAT;
 	p->data.f = data;
 	return p;
@@ -220,11 +405,8 @@ ConstantNode *createFloatConstantNode(float data)
  */
 ConstantNode *createStringConstantNode(char *data)
 {
-	ConstantNode *p = malloc(sizeof(ConstantNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	ConstantNode *p = allocNode(sizeof(ConstantNode));
+	if (!p) return NULL;
 	p->type = CT_STRING;
 	p->data.s = data;
 	return p;
@@ -235,13 +417,12 @@ ConstantNode *createStringConstantNode(char *data)
  *
  * \param [in,out] node The constant to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteConstantNode(ConstantNode *node)
 {
-	if (!node) return;
-	if (node->type == CT_STRING) free(node->data.s);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -267,17 +448,13 @@ IdentifierNode *createIdentifierNode(IdentifierType type,
                                      const char *fname,
                                      unsigned int line)
 {
-	IdentifierNode *p = malloc(sizeof(IdentifierNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	IdentifierNode *p = allocNode(sizeof(IdentifierNode));
+	if (!p) return NULL;
 	p->type = type;
 	p->id = id;
 	p->slot = slot;
 	if (fname) {
-		p->fname = malloc(sizeof(char) * (strlen(fname) + 1));
-		strcpy(p->fname, fname);
+		p->fname = internParserString(fname);
 	}
 	else {
 		p->fname = NULL;
@@ -291,27 +468,12 @@ IdentifierNode *createIdentifierNode(IdentifierType type,
  *
  * \param [in,out] node The identifier to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteIdentifierNode(IdentifierNode *node)
 {
-	if (!node) return;
-	switch (node->type) {
-		case IT_DIRECT: {
-			free(node->id);
-			break;
-		}
-		case IT_INDIRECT: {
-			deleteExprNode(node->id);
-			break;
-		}
-		default:
-			error(PR_UNKNOWN_IDENTIFIER_TYPE, node->fname, node->line);
-			break;
-	}
-	if (node->slot) deleteIdentifierNode(node->slot);
-	if (node->fname) free(node->fname);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -323,12 +485,10 @@ void deleteIdentifierNode(IdentifierNode *node)
  */
 IdentifierNodeList *createIdentifierNodeList(void)
 {
-	IdentifierNodeList *p = malloc(sizeof(IdentifierNodeList));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	IdentifierNodeList *p = allocNode(sizeof(IdentifierNodeList));
+	if (!p) return NULL;
 	p->num = 0;
+	p->cap = 0;
 	p->ids = NULL;
 	return p;
 }
@@ -350,15 +510,20 @@ IdentifierNodeList *createIdentifierNodeList(void)
 int addIdentifierNode(IdentifierNodeList *list,
                       IdentifierNode *node)
 {
-	unsigned int newsize = list->num + 1;
-	void *mem = realloc(list->ids, sizeof(IdentifierNode *) * newsize);
-	if (!mem) {
-		perror("realloc");
-		return 0;
+	if (list->num == list->cap) {
+		/* Grow geometrically; the old array is left behind in the
+		 * arena and freed with everything else */
+		unsigned int newcap = list->cap ? list->cap * 2 : 4;
+		IdentifierNode **mem = arenaAlloc(sizeof(IdentifierNode *) * newcap);
+		if (!mem) return 0;
+		/* The array pointer is NULL until the first growth */
+		if (list->num)
+			memcpy(mem, list->ids, sizeof(IdentifierNode *) * list->num);
+		list->ids = mem;
+		list->cap = newcap;
 	}
-	list->ids = mem;
 	list->ids[list->num] = node;
-	list->num = newsize;
+	list->num++;
 	return 1;
 }
 
@@ -367,16 +532,12 @@ int addIdentifierNode(IdentifierNodeList *list,
  *
  * \param [in,out] list The list of identifiers to delete.
  *
- * \post The memory at \a list and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a list belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteIdentifierNodeList(IdentifierNodeList *list)
 {
-	unsigned int n;
-	if (!list) return;
-	for (n = 0; n < list->num; n++)
-		deleteIdentifierNode(list->ids[n]);
-	free(list->ids);
-	free(list);
+	(void)list;
 }
 
 /**
@@ -390,11 +551,8 @@ void deleteIdentifierNodeList(IdentifierNodeList *list)
  */
 TypeNode *createTypeNode(ConstantType type)
 {
-	TypeNode *p = malloc(sizeof(TypeNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	TypeNode *p = allocNode(sizeof(TypeNode));
+	if (!p) return NULL;
 	p->type = type;
 	return p;
 }
@@ -404,12 +562,12 @@ TypeNode *createTypeNode(ConstantType type)
  *
  * \param [in,out] node The type to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteTypeNode(TypeNode *node)
 {
-	if (!node) return;
-	free(node);
+	(void)node;
 }
 
 /**
@@ -426,11 +584,8 @@ void deleteTypeNode(TypeNode *node)
 StmtNode *createStmtNode(StmtType type,
                          void *stmt)
 {
-	StmtNode *p = malloc(sizeof(StmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	StmtNode *p = allocNode(sizeof(StmtNode));
+	if (!p) return NULL;
 	p->type = type;
 	p->stmt = stmt;
 	return p;
@@ -441,84 +596,12 @@ StmtNode *createStmtNode(StmtType type,
  *
  * \param [in,out] node The statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteStmtNode(StmtNode *node)
 {
-	if (!node) return;
-	switch (node->type) {
-		case ST_CAST: {
-			CastStmtNode *stmt = (CastStmtNode *)node->stmt;
-			deleteCastStmtNode(stmt);
-			break;
-		}
-		case ST_PRINT: {
-			PrintStmtNode *stmt = (PrintStmtNode *)node->stmt;
-			deletePrintStmtNode(stmt);
-			break;
-		}
-		case ST_INPUT: {
-			InputStmtNode *stmt = (InputStmtNode *)node->stmt;
-			deleteInputStmtNode(stmt);
-			break;
-		}
-		case ST_ASSIGNMENT: {
-			AssignmentStmtNode *stmt = (AssignmentStmtNode *)node->stmt;
-			deleteAssignmentStmtNode(stmt);
-			break;
-		}
-		case ST_DECLARATION: {
-			DeclarationStmtNode *stmt = (DeclarationStmtNode *)node->stmt;
-			deleteDeclarationStmtNode(stmt);
-			break;
-		}
-		case ST_IFTHENELSE: {
-			IfThenElseStmtNode *stmt = (IfThenElseStmtNode *)node->stmt;
-			deleteIfThenElseStmtNode(stmt);
-			break;
-		}
-		case ST_SWITCH: {
-			SwitchStmtNode *stmt = (SwitchStmtNode *)node->stmt;
-			deleteSwitchStmtNode(stmt);
-			break;
-		}
-		case ST_BREAK:
-			break; /* This statement type does not have any content */
-		case ST_RETURN: {
-			ReturnStmtNode *stmt = (ReturnStmtNode *)node->stmt;
-			deleteReturnStmtNode(stmt);
-			break;
-		}
-		case ST_LOOP: {
-			LoopStmtNode *stmt = (LoopStmtNode *)node->stmt;
-			deleteLoopStmtNode(stmt);
-			break;
-		}
-		case ST_DEALLOCATION: {
-			DeallocationStmtNode *stmt = (DeallocationStmtNode *)node->stmt;
-			deleteDeallocationStmtNode(stmt);
-			break;
-		}
-		case ST_FUNCDEF: {
-			FuncDefStmtNode *stmt = (FuncDefStmtNode *)node->stmt;
-			deleteFuncDefStmtNode(stmt);
-			break;
-		}
-		case ST_EXPR: {
-			ExprNode *expr = (ExprNode *)node->stmt;
-			deleteExprNode(expr);
-			break;
-		}
-		case ST_ALTARRAYDEF: {
-			AltArrayDefStmtNode *stmt = (AltArrayDefStmtNode *)node->stmt;
-			deleteAltArrayDefStmtNode(stmt);
-			break;
-		}
-		default:
-			error(PR_UNKNOWN_STATEMENT_TYPE);
-			break;
-	}
-	free(node);
+	(void)node;
 }
 
 /**
@@ -530,12 +613,10 @@ void deleteStmtNode(StmtNode *node)
  */
 StmtNodeList *createStmtNodeList(void)
 {
-	StmtNodeList *p = malloc(sizeof(StmtNodeList));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	StmtNodeList *p = allocNode(sizeof(StmtNodeList));
+	if (!p) return NULL;
 	p->num = 0;
+	p->cap = 0;
 	p->stmts = NULL;
 	return p;
 }
@@ -556,15 +637,21 @@ StmtNodeList *createStmtNodeList(void)
 int addStmtNode(StmtNodeList *list,
                 StmtNode *node)
 {
-	unsigned int newsize = list->num + 1;
-	void *mem = realloc(list->stmts, sizeof(StmtNode *) * newsize);
-	if (!mem) {
-		perror("realloc");
-		return 0;
+	if (list->num == list->cap) {
+		/* Grow geometrically, seeding enough room for a typical code
+		 * block; the old array is left behind in the arena and freed
+		 * with everything else */
+		unsigned int newcap = list->cap ? list->cap * 2 : 8;
+		StmtNode **mem = arenaAlloc(sizeof(StmtNode *) * newcap);
+		if (!mem) return 0;
+		/* The array pointer is NULL until the first growth */
+		if (list->num)
+			memcpy(mem, list->stmts, sizeof(StmtNode *) * list->num);
+		list->stmts = mem;
+		list->cap = newcap;
 	}
-	list->stmts = mem;
 	list->stmts[list->num] = node;
-	list->num = newsize;
+	list->num++;
 	return 1;
 }
 
@@ -573,16 +660,12 @@ int addStmtNode(StmtNodeList *list,
  *
  * \param [in,out] list The statement list to delete.
  *
- * \post The memory at \a list and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a list belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteStmtNodeList(StmtNodeList *list)
 {
-	unsigned int n;
-	if (!list) return;
-	for (n = 0; n < list->num; n++)
-		deleteStmtNode(list->stmts[n]);
-	free(list->stmts);
-	free(list);
+	(void)list;
 }
 
 /**
@@ -590,7 +673,8 @@ void deleteStmtNodeList(StmtNodeList *list)
  *
  * \param [in] target The variable to cast to \a newtype.
  *
- * \param [in] newtype The type to cast \a target to.
+ * \param [in] newtype The type to cast \a target to (copied by value; the
+ * caller retains ownership of the structure it points to).
  *
  * \return A pointer to a cast statement with the desired properties.
  *
@@ -599,13 +683,10 @@ void deleteStmtNodeList(StmtNodeList *list)
 CastStmtNode *createCastStmtNode(IdentifierNode *target,
                                  TypeNode *newtype)
 {
-	CastStmtNode *p = malloc(sizeof(CastStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	CastStmtNode *p = allocNode(sizeof(CastStmtNode));
+	if (!p) return NULL;
 	p->target = target;
-	p->newtype = newtype;
+	p->newtype = *newtype;
 	return p;
 }
 
@@ -614,14 +695,12 @@ CastStmtNode *createCastStmtNode(IdentifierNode *target,
  *
  * \param [in,out] node The cast statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteCastStmtNode(CastStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->target);
-	deleteTypeNode(node->newtype);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -641,11 +720,8 @@ PrintStmtNode *createPrintStmtNode(ExprNodeList *args,
                                    FILE *file,
                                    int nonl)
 {
-	PrintStmtNode *p = malloc(sizeof(PrintStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	PrintStmtNode *p = allocNode(sizeof(PrintStmtNode));
+	if (!p) return NULL;
 	p->args = args;
 	p->file = file;
 	p->nonl = nonl;
@@ -657,13 +733,12 @@ PrintStmtNode *createPrintStmtNode(ExprNodeList *args,
  *
  * \param [in,out] node The print statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deletePrintStmtNode(PrintStmtNode *node)
 {
-	if (!node) return;
-	deleteExprNodeList(node->args);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -677,11 +752,8 @@ void deletePrintStmtNode(PrintStmtNode *node)
  */
 InputStmtNode *createInputStmtNode(IdentifierNode *target)
 {
-	InputStmtNode *p = malloc(sizeof(InputStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	InputStmtNode *p = allocNode(sizeof(InputStmtNode));
+	if (!p) return NULL;
 	p->target = target;
 	return p;
 }
@@ -691,13 +763,12 @@ InputStmtNode *createInputStmtNode(IdentifierNode *target)
  *
  * \param [in,out] node The input statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteInputStmtNode(InputStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->target);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -714,11 +785,8 @@ void deleteInputStmtNode(InputStmtNode *node)
 AssignmentStmtNode *createAssignmentStmtNode(IdentifierNode *target,
                                              ExprNode *expr)
 {
-	AssignmentStmtNode *p = malloc(sizeof(AssignmentStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	AssignmentStmtNode *p = allocNode(sizeof(AssignmentStmtNode));
+	if (!p) return NULL;
 	p->target = target;
 	p->expr = expr;
 	return p;
@@ -729,14 +797,12 @@ AssignmentStmtNode *createAssignmentStmtNode(IdentifierNode *target,
  *
  * \param [in,out] node The assignment statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteAssignmentStmtNode(AssignmentStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->target);
-	deleteExprNode(node->expr);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -762,11 +828,8 @@ DeclarationStmtNode *createDeclarationStmtNode(IdentifierNode *scope,
                                                TypeNode *type,
                                                IdentifierNode *parent)
 {
-	DeclarationStmtNode *p = malloc(sizeof(DeclarationStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	DeclarationStmtNode *p = allocNode(sizeof(DeclarationStmtNode));
+	if (!p) return NULL;
 	p->scope = scope;
 	p->target = target;
 	p->expr = expr;
@@ -780,17 +843,12 @@ DeclarationStmtNode *createDeclarationStmtNode(IdentifierNode *scope,
  *
  * \param [in,out] node The declaration statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteDeclarationStmtNode(DeclarationStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->scope);
-	deleteIdentifierNode(node->target);
-	deleteExprNode(node->expr);
-	deleteTypeNode(node->type);
-	deleteIdentifierNode(node->parent);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -817,11 +875,8 @@ IfThenElseStmtNode *createIfThenElseStmtNode(BlockNode *yes,
                                              ExprNodeList *guards,
                                              BlockNodeList *blocks)
 {
-	IfThenElseStmtNode *p = malloc(sizeof(IfThenElseStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	IfThenElseStmtNode *p = allocNode(sizeof(IfThenElseStmtNode));
+	if (!p) return NULL;
 	p->yes = yes;
 	p->no = no;
 	p->guards = guards;
@@ -834,16 +889,12 @@ IfThenElseStmtNode *createIfThenElseStmtNode(BlockNode *yes,
  *
  * \param [in,out] node The if/then/else statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteIfThenElseStmtNode(IfThenElseStmtNode *node)
 {
-	if (!node) return;
-	deleteBlockNode(node->yes);
-	deleteBlockNode(node->no);
-	deleteExprNodeList(node->guards);
-	deleteBlockNodeList(node->blocks);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -866,11 +917,8 @@ SwitchStmtNode *createSwitchStmtNode(ExprNodeList *guards,
                                      BlockNodeList *blocks,
                                      BlockNode *def)
 {
-	SwitchStmtNode *p = malloc(sizeof(SwitchStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	SwitchStmtNode *p = allocNode(sizeof(SwitchStmtNode));
+	if (!p) return NULL;
 	p->guards = guards;
 	p->blocks = blocks;
 	p->def = def;
@@ -882,15 +930,12 @@ SwitchStmtNode *createSwitchStmtNode(ExprNodeList *guards,
  *
  * \param [in,out] node The switch statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteSwitchStmtNode(SwitchStmtNode *node)
 {
-	if (!node) return;
-	deleteExprNodeList(node->guards);
-	deleteBlockNodeList(node->blocks);
-	deleteBlockNode(node->def);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -904,11 +949,8 @@ void deleteSwitchStmtNode(SwitchStmtNode *node)
  */
 ReturnStmtNode *createReturnStmtNode(ExprNode *value)
 {
-	ReturnStmtNode *p = malloc(sizeof(ReturnStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	ReturnStmtNode *p = allocNode(sizeof(ReturnStmtNode));
+	if (!p) return NULL;
 	p->value = value;
 	return p;
 }
@@ -918,13 +960,12 @@ ReturnStmtNode *createReturnStmtNode(ExprNode *value)
  *
  * \param [in,out] node The return statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteReturnStmtNode(ReturnStmtNode *node)
 {
-	if (!node) return;
-	deleteExprNode(node->value);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -936,6 +977,8 @@ void deleteReturnStmtNode(ReturnStmtNode *node)
  *
  * \param [in] guard The expression to determine if the loop continues.
  *
+ * \param [in] invert Whether to invert the result of \a guard.
+ *
  * \param [in] update The expression to update \a var using.
  *
  * \param [in] body The code block to execute with each loop iteration.
@@ -947,17 +990,16 @@ void deleteReturnStmtNode(ReturnStmtNode *node)
 LoopStmtNode *createLoopStmtNode(IdentifierNode *name,
                                  IdentifierNode *var,
                                  ExprNode *guard,
+                                 int invert,
                                  ExprNode *update,
                                  BlockNode *body)
 {
-	LoopStmtNode *p = malloc(sizeof(LoopStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	LoopStmtNode *p = allocNode(sizeof(LoopStmtNode));
+	if (!p) return NULL;
 	p->name = name;
 	p->var = var;
 	p->guard = guard;
+	p->invert = invert;
 	p->update = update;
 	p->body = body;
 	return p;
@@ -968,17 +1010,12 @@ LoopStmtNode *createLoopStmtNode(IdentifierNode *name,
  *
  * \param [in,out] node The loop statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteLoopStmtNode(LoopStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->name);
-	deleteIdentifierNode(node->var);
-	deleteExprNode(node->guard);
-	deleteExprNode(node->update);
-	deleteBlockNode(node->body);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -992,11 +1029,8 @@ void deleteLoopStmtNode(LoopStmtNode *node)
  */
 DeallocationStmtNode *createDeallocationStmtNode(IdentifierNode *target)
 {
-	DeallocationStmtNode *p = malloc(sizeof(DeallocationStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	DeallocationStmtNode *p = allocNode(sizeof(DeallocationStmtNode));
+	if (!p) return NULL;
 	p->target = target;
 	return p;
 }
@@ -1006,13 +1040,12 @@ DeallocationStmtNode *createDeallocationStmtNode(IdentifierNode *target)
  *
  * \param [in,out] node The deallocation statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteDeallocationStmtNode(DeallocationStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->target);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -1036,11 +1069,8 @@ FuncDefStmtNode *createFuncDefStmtNode(IdentifierNode *scope,
                                        IdentifierNodeList *args,
                                        BlockNode *body)
 {
-	FuncDefStmtNode *p = malloc(sizeof(FuncDefStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	FuncDefStmtNode *p = allocNode(sizeof(FuncDefStmtNode));
+	if (!p) return NULL;
 	p->scope = scope;
 	p->name = name;
 	p->args = args;
@@ -1053,16 +1083,12 @@ FuncDefStmtNode *createFuncDefStmtNode(IdentifierNode *scope,
  *
  * \param [in,out] node The function definition statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteFuncDefStmtNode(FuncDefStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->scope);
-	deleteIdentifierNode(node->name);
-	deleteIdentifierNodeList(node->args);
-	deleteBlockNode(node->body);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -1083,11 +1109,8 @@ AltArrayDefStmtNode *createAltArrayDefStmtNode(IdentifierNode *name,
                                                BlockNode *body,
                                                IdentifierNode *parent)
 {
-	AltArrayDefStmtNode *p = malloc(sizeof(AltArrayDefStmtNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	AltArrayDefStmtNode *p = allocNode(sizeof(AltArrayDefStmtNode));
+	if (!p) return NULL;
 	p->name = name;
 	p->body = body;
 	p->parent = parent;
@@ -1099,14 +1122,12 @@ AltArrayDefStmtNode *createAltArrayDefStmtNode(IdentifierNode *name,
  *
  * \param [in,out] node The alternate array definition statement to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteAltArrayDefStmtNode(AltArrayDefStmtNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->name);
-	deleteBlockNode(node->body);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -1123,13 +1144,9 @@ void deleteAltArrayDefStmtNode(AltArrayDefStmtNode *node)
 ExprNode *createExprNode(ExprType type,
                          void *expr)
 {
-	ExprNode *p = malloc(sizeof(ExprNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
-	p->type = type;
-	p->expr = expr;
+	ExprNode *p = allocNode(sizeof(ExprNode));
+	if (!p) return NULL;
+	setExprNode(p, type, expr);
 	return p;
 }
 
@@ -1138,34 +1155,12 @@ ExprNode *createExprNode(ExprType type,
  *
  * \param [in,out] node The expression to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteExprNode(ExprNode *node)
 {
-	if (!node) return;
-	switch (node->type) {
-		case ET_CAST:
-			deleteCastExprNode((CastExprNode *)node->expr);
-			break;
-		case ET_CONSTANT:
-			deleteConstantNode((ConstantNode *)node->expr);
-			break;
-		case ET_IDENTIFIER:
-			deleteIdentifierNode((IdentifierNode *)node->expr);
-			break;
-		case ET_FUNCCALL:
-			deleteFuncCallExprNode((FuncCallExprNode *)node->expr);
-			break;
-		case ET_OP:
-			deleteOpExprNode((OpExprNode *)node->expr);
-			break;
-		case ET_IMPVAR:
-			break; /* This expression type does not have any content */
-		default:
-			error(PR_UNKNOWN_EXPRESSION_TYPE);
-			break;
-	}
-	free(node);
+	(void)node;
 }
 
 /**
@@ -1177,13 +1172,11 @@ void deleteExprNode(ExprNode *node)
  */
 ExprNodeList *createExprNodeList(void)
 {
-	ExprNodeList *p = malloc(sizeof(ExprNodeList));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	ExprNodeList *p = allocNode(sizeof(ExprNodeList));
+	if (!p) return NULL;
 	p->num = 0;
-	p->exprs = NULL;
+	p->cap = sizeof(p->inline_) / sizeof(p->inline_[0]);
+	p->exprs = p->inline_;
 	return p;
 }
 
@@ -1203,15 +1196,20 @@ ExprNodeList *createExprNodeList(void)
 int addExprNode(ExprNodeList *list,
                 ExprNode *node)
 {
-	unsigned int newsize = list->num + 1;
-	void *mem = realloc(list->exprs, sizeof(ExprNode *) * newsize);
-	if (!mem) {
-		perror("realloc");
-		return 0;
+	if (list->num == list->cap) {
+		/* Lists start out in their inline buffer, which is large
+		 * enough for most argument lists; once it overflows, spill to
+		 * the arena (the old array is left behind and freed with
+		 * everything else) */
+		unsigned int newcap = list->cap * 2;
+		ExprNode **mem = arenaAlloc(sizeof(ExprNode *) * newcap);
+		if (!mem) return 0;
+		memcpy(mem, list->exprs, sizeof(ExprNode *) * list->num);
+		list->exprs = mem;
+		list->cap = newcap;
 	}
-	list->exprs = mem;
 	list->exprs[list->num] = node;
-	list->num = newsize;
+	list->num++;
 	return 1;
 }
 
@@ -1220,16 +1218,12 @@ int addExprNode(ExprNodeList *list,
  *
  * \param [in,out] list The expression list to delete.
  *
- * \post The memory at \a list and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a list belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteExprNodeList(ExprNodeList *list)
 {
-	unsigned int n;
-	if (!list) return;
-	for (n = 0; n < list->num; n++)
-		deleteExprNode(list->exprs[n]);
-	free(list->exprs);
-	free(list);
+	(void)list;
 }
 
 /**
@@ -1237,7 +1231,8 @@ void deleteExprNodeList(ExprNodeList *list)
  *
  * \param [in] target The expression to cast.
  *
- * \param [in] newtype The type to cast \a target to.
+ * \param [in] newtype The type to cast \a target to (copied by value; the
+ * caller retains ownership of the structure it points to).
  *
  * \return A pointer to a cast expression with the desired properties.
  *
@@ -1246,13 +1241,10 @@ void deleteExprNodeList(ExprNodeList *list)
 CastExprNode *createCastExprNode(ExprNode *target,
                                  TypeNode *newtype)
 {
-	CastExprNode *p = malloc(sizeof(CastExprNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	CastExprNode *p = allocNode(sizeof(CastExprNode));
+	if (!p) return NULL;
 	p->target = target;
-	p->newtype = newtype;
+	p->newtype = *newtype;
 	return p;
 }
 
@@ -1261,14 +1253,12 @@ CastExprNode *createCastExprNode(ExprNode *target,
  *
  * \param [in,out] node The cast expression to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteCastExprNode(CastExprNode *node)
 {
-	if (!node) return;
-	deleteExprNode(node->target);
-	deleteTypeNode(node->newtype);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -1288,11 +1278,8 @@ FuncCallExprNode *createFuncCallExprNode(IdentifierNode *scope,
                                          IdentifierNode *name,
                                          ExprNodeList *args)
 {
-	FuncCallExprNode *p = malloc(sizeof(FuncCallExprNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	FuncCallExprNode *p = allocNode(sizeof(FuncCallExprNode));
+	if (!p) return NULL;
 	p->scope = scope;
 	p->name = name;
 	p->args = args;
@@ -1304,15 +1291,12 @@ FuncCallExprNode *createFuncCallExprNode(IdentifierNode *scope,
  *
  * \param [in,out] node The function call expression to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteFuncCallExprNode(FuncCallExprNode *node)
 {
-	if (!node) return;
-	deleteIdentifierNode(node->scope);
-	deleteIdentifierNode(node->name);
-	deleteExprNodeList(node->args);
-	free(node);
+	(void)node;
 }
 
 /**
@@ -1329,11 +1313,8 @@ void deleteFuncCallExprNode(FuncCallExprNode *node)
 OpExprNode *createOpExprNode(OpType type,
                              ExprNodeList *args)
 {
-	OpExprNode *p = malloc(sizeof(OpExprNode));
-	if (!p) {
-		perror("malloc");
-		return NULL;
-	}
+	OpExprNode *p = allocNode(sizeof(OpExprNode));
+	if (!p) return NULL;
 	p->type = type;
 	p->args = args;
 	return p;
@@ -1344,81 +1325,12 @@ OpExprNode *createOpExprNode(OpType type,
  *
  * \param [in,out] node The operation expression to delete.
  *
- * \post The memory at \a node and all of its members will be freed.
+ * \post Nothing will happen; the memory at \a node belongs to the parser's
+ * arena and is not freed until deleteMainNode() is called.
  */
 void deleteOpExprNode(OpExprNode *node)
 {
-	if (!node) return;
-	deleteExprNodeList(node->args);
-	free(node);
-}
-
-/**
- * Checks if a type of token is at a position in a token list, and if so,
- * advances the position.
- *
- * \param [in,out] tokenp The position in a token list to check.
- *
- * \param [in] token The type of token to check for.
- *
- * \post If the type of \a tokenp is not \a token, \a tokenp will remain
- * unchanged, else, it will point to the token after the one matched.
- *
- * \retval 0 The type of \a tokenp is \a token.
- *
- * \retval 1 The type of \a tokenp is not \a token.
- */
-int acceptToken(Token ***tokenp,
-                TokenType token)
-{
-	Token **tokens = *tokenp;
-	if (!(*tokens)) return 0;
-	if ((*tokens)->type != token) return 0;
-	tokens++;
-	*tokenp = tokens;
-	return 1;
-}
-
-/**
- * Checks if a type of token is at a position in a token list.
- *
- * \param [in] tokenp The position in a token list to check.
- *
- * \param [in] token The type of token to check for.
- *
- * \post \a tokenp will remain unchanged.
- *
- * \retval 0 The type of \a tokenp is \a token.
- *
- * \retval 1 The type of \a tokenp is not \a token.
- */
-int peekToken(Token ***tokenp,
-              TokenType token)
-{
-	Token **tokens = *tokenp;
-	if ((*tokens)->type != token) return 0;
-	return 1;
-}
-
-/**
- * Checks if a type of token is after a position in a token list.
- *
- * \param [in] tokenp The position in a token list to check after.
- *
- * \param [in] token The type of token to check for.
- *
- * \post \a tokenp will remain unchanged.
- *
- * \retval 0 The type of the token after \a tokenp is \a token.
- *
- * \retval 1 The type of the token after \a tokenp is not \a token.
- */
-int nextToken(Token ***tokenp,
-         TokenType token)
-{
-	Token **tokens = *tokenp;
-	if ((*(tokens + 1))->type != token) return 0;
-	return 1;
+	(void)node;
 }
 
 /**
@@ -1479,6 +1391,43 @@ void parser_error_expected_either_token(TokenType token1,
 			(*tokens)->image);
 }
 
+/**
+ * Accepts a token of a particular type, flagging an expected-token error and
+ * jumping to an abort label if a token of that type is not present.
+ *
+ * Both macros expect a local \c tokens cursor of type Token ** to be in scope,
+ * as is the convention in every parser function.  They hoist the boilerplate
+ * accept-check-error-abort sequence out of the happy path so that the error
+ * handling code stays off to one side.
+ *
+ * \param [in] type The type of token to accept.
+ *
+ * \param [in] label The abort label to jump to if the token is not present.
+ */
+#define EXPECT_TOKEN(type, label) do { \
+	if (!acceptToken(&tokens, type)) { \
+		parser_error_expected_token(type, tokens); \
+		goto label; \
+	} \
+} while (0)
+
+/**
+ * Accepts a token of a particular type, flagging a specific parser error and
+ * jumping to an abort label if a token of that type is not present.
+ *
+ * \param [in] type The type of token to accept.
+ *
+ * \param [in] err The type of error to flag if the token is not present.
+ *
+ * \param [in] label The abort label to jump to if the token is not present.
+ */
+#define EXPECT_TOKEN_ERROR(type, err, label) do { \
+	if (!acceptToken(&tokens, type)) { \
+		parser_error(err, tokens); \
+		goto label; \
+	} \
+} while (0)
+
 /**
  * Parses tokens into a constant.
  *
@@ -1494,95 +1443,68 @@ ConstantNode *parseConstantNode(Token ***tokenp)
 {
 	ConstantNode *ret = NULL;
 	char *data = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
+	/* Read the current token once; the double indirection through the
+	 * cursor defeats the optimizer otherwise */
+	Token *cur = *tokens;
+
 	shiftout();
-#endif
 
+	switch (cur->type) {
 	/* Boolean */
-	if (peekToken(&tokens, TT_BOOLEAN)) {
-#ifdef DEBUG
+	case TT_BOOLEAN:
 		debug("CT_BOOLEAN");
-#endif
 		/* Create the ConstantNode structure */
-		ret = createBooleanConstantNode((*tokens)->data.i);
+		ret = createBooleanConstantNode(cur->data.i);
 		if (!ret) goto parseConstantNodeAbort;
-
-		/* This should succeed; it was checked for above */
-		status = acceptToken(&tokens, TT_BOOLEAN);
-		if (!status) {
-			parser_error(PR_EXPECTED_BOOLEAN, tokens);
-			goto parseConstantNodeAbort;
-		}
-	}
+		tokens++;
+		break;
 	/* Integer */
-	else if (peekToken(&tokens, TT_INTEGER)) {
-#ifdef DEBUG
+	case TT_INTEGER:
 		debug("CT_INTEGER");
-#endif
 		/* Create the ConstantNode structure */
-		ret = createIntegerConstantNode((*tokens)->data.i);
+		ret = createIntegerConstantNode(cur->data.i);
 		if (!ret) goto parseConstantNodeAbort;
-
-		/* This should succeed; it was checked for above */
-		status = acceptToken(&tokens, TT_INTEGER);
-		if (!status) {
-			parser_error(PR_EXPECTED_INTEGER, tokens);
-			goto parseConstantNodeAbort;
-		}
-	}
+		tokens++;
+		break;
 	/* Float */
-	else if (peekToken(&tokens, TT_FLOAT)) {
-#ifdef DEBUG
+	case TT_FLOAT:
 		debug("CT_FLOAT");
-#endif
 		/* Create the ConstantNode structure */
-		ret = createFloatConstantNode((*tokens)->data.f);
+		ret = createFloatConstantNode(cur->data.f);
 		if (!ret) goto parseConstantNodeAbort;
-
-		/* This should succeed; it was checked for above */
-		status = acceptToken(&tokens, TT_FLOAT);
-		if (!status) {
-			parser_error(PR_EXPECTED_FLOAT, tokens);
-			goto parseConstantNodeAbort;
-		}
-	}
+		tokens++;
+		break;
 	/* String */
-	else if (peekToken(&tokens, TT_STRING)) {
-		size_t len = strlen((*tokens)->image);
-		data = malloc(sizeof(char) * (len - 1));
-		if (!data) {
-			perror("malloc");
-			goto parseConstantNodeAbort;
-		}
-		strncpy(data, (*tokens)->image + 1, len - 2);
+	case TT_STRING: {
+		size_t len = strlen(cur->image);
+		data = arenaAlloc(sizeof(char) * (len - 1));
+		if (!data) goto parseConstantNodeAbort;
+		/* The length is already known, so a straight memcpy beats
+		 * strncpy here */
+		memcpy(data, cur->image + 1, len - 2);
 		data[len - 2] = '\0';
-#ifdef DEBUG
+		/* Intern the string so equal constants share one copy and
+		 * compare by address */
+		data = internParserString(data);
+		if (!data) goto parseConstantNodeAbort;
 		debug("CT_STRING");
-#endif
 		/* Create the ConstantNode structure */
 		ret = createStringConstantNode(data);
 		if (!ret) goto parseConstantNodeAbort;
 		data = NULL;
-
-		/* This should succeed; it was checked for above */
-		status = acceptToken(&tokens, TT_STRING);
-		if (!status) {
-			parser_error(PR_EXPECTED_STRING, tokens);
-			goto parseConstantNodeAbort;
-		}
+		tokens++;
+		break;
 	}
-	else {
+	default:
 		parser_error(PR_EXPECTED_CONSTANT, tokens);
+		break;
 	}
 
-#ifdef DEBUG
 	shiftin();
-#endif
 
 	/* Since we're successful, update the token stream */
 	*tokenp = tokens;
@@ -1592,7 +1514,6 @@ ConstantNode *parseConstantNode(Token ***tokenp)
 parseConstantNodeAbort: /* Exception handling */
 
 	/* Clean up any allocated structures */
-	if (data) free(data);
 	if (ret) deleteConstantNode(ret);
 
 	return NULL;
@@ -1616,55 +1537,41 @@ TypeNode *parseTypeNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	shiftout();
-#endif
 
 	/* Nil */
 	if (acceptToken(&tokens, TT_NOOB)) {
-#ifdef DEBUG
 		debug("CT_NIL");
-#endif
 		ret = createTypeNode(CT_NIL);
 		if (!ret) goto parseTypeNodeAbort;
 	}
 	/* Boolean */
 	else if (acceptToken(&tokens, TT_TROOF)) {
-#ifdef DEBUG
 		debug("CT_BOOLEAN");
-#endif
 		ret = createTypeNode(CT_BOOLEAN);
 		if (!ret) goto parseTypeNodeAbort;
 	}
 	/* Integer */
 	else if (acceptToken(&tokens, TT_NUMBR)) {
-#ifdef DEBUG
 		debug("CT_INTEGER");
-#endif
 		ret = createTypeNode(CT_INTEGER);
 		if (!ret) goto parseTypeNodeAbort;
 	}
 	/* Float */
 	else if (acceptToken(&tokens, TT_NUMBAR)) {
-#ifdef DEBUG
 		debug("CT_FLOAT");
-#endif
 		ret = createTypeNode(CT_FLOAT);
 		if (!ret) goto parseTypeNodeAbort;
 	}
 	/* String */
 	else if (acceptToken(&tokens, TT_YARN)) {
-#ifdef DEBUG
 		debug("CT_STRING");
-#endif
 		ret = createTypeNode(CT_STRING);
 		if (!ret) goto parseTypeNodeAbort;
 	}
 	/* Associative array */
 	else if (acceptToken(&tokens, TT_BUKKIT)) {
-#ifdef DEBUG
 		debug("CT_ARRAY");
-#endif
 		ret = createTypeNode(CT_ARRAY);
 		if (!ret) goto parseTypeNodeAbort;
 	}
@@ -1672,9 +1579,7 @@ TypeNode *parseTypeNode(Token ***tokenp)
 		parser_error(PR_EXPECTED_TYPE, tokens);
 	}
 
-#ifdef DEBUG
 	shiftin();
-#endif
 
 	/* Since we're successful, update the token stream */
 	*tokenp = tokens;
@@ -1715,42 +1620,32 @@ IdentifierNode *parseIdentifierNode(Token ***tokenp)
 	ExprNode *expr = NULL;
 
 	IdentifierNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
+	/* Read the current token once; the double indirection through the
+	 * cursor defeats the optimizer otherwise */
+	Token *cur = *tokens;
+
 	shiftout();
-#endif
 
-	fname = (*tokens)->fname;
-	line = (*tokens)->line;
+	fname = cur->fname;
+	line = cur->line;
 
 	/* Direct identifier */
-	if (peekToken(&tokens, TT_IDENTIFIER)) {
+	if (cur->type == TT_IDENTIFIER) {
 		type = IT_DIRECT;
-#ifdef DEBUG
 		debug("IT_DIRECT");
-#endif
-		/* Copy the token image */
-		temp = malloc(sizeof(char) * (strlen((*tokens)->image) + 1));
+		/* Intern the token image */
+		temp = internParserString(cur->image);
 		if (!temp) goto parseIdentifierNodeAbort;
-		strcpy(temp, (*tokens)->image);
 		data = temp;
-
-		/* This should succeed; it was checked for above */
-		status = acceptToken(&tokens, TT_IDENTIFIER);
-		if (!status) {
-			parser_error(PR_EXPECTED_IDENTIFIER, tokens);
-			goto parseIdentifierNodeAbort;
-		}
+		tokens++;
 	}
 	else if (acceptToken(&tokens, TT_SRS)) {
 		type = IT_INDIRECT;
-#ifdef DEBUG
 		debug("IT_INDIRECT");
-#endif
 		/* Parse the expression representing the identifier */
 		expr = parseExprNode(&tokens);
 		if (!expr) goto parseIdentifierNodeAbort;
@@ -1766,9 +1661,7 @@ IdentifierNode *parseIdentifierNode(Token ***tokenp)
 		if (!slot) goto parseIdentifierNodeAbort;
 	}
 
-#ifdef DEBUG
 	shiftin();
-#endif
 
 	/* Create the new IdentifierNode structure */
 	ret = createIdentifierNode(type, data, slot, fname, line);
@@ -1787,9 +1680,6 @@ parseIdentifierNodeAbort: /* Exception handling */
 		/* For indirect identifier */
 		if (expr) deleteExprNode(expr);
 
-		/* For direct identifier */
-		if (temp) free(temp);
-
 		if (slot) deleteIdentifierNode(slot);
 	}
 
@@ -1813,40 +1703,51 @@ ExprNode *parseCastExprNode(Token ***tokenp)
 	TypeNode *newtype = NULL;
 	CastExprNode *expr = NULL;
 	ExprNode *ret = NULL;
-	int status;
+	unsigned int depth = 0;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ET_CAST");
-#endif
 
 	/* Parse the cast token */
-	status = acceptToken(&tokens, TT_MAEK);
-	if (!status) {
-		parser_error_expected_token(TT_MAEK, tokens);
-		goto parseCastExprNodeAbort;
-	}
+	EXPECT_TOKEN(TT_MAEK, parseCastExprNodeAbort);
+	depth++;
+
+	/* Count any further leading cast tokens so that chained casts are
+	 * handled iteratively instead of by recursing through
+	 * parseExprNode */
+	while (acceptToken(&tokens, TT_MAEK)) depth++;
 
 	/* Parse the expression to cast */
 	target = parseExprNode(&tokens);
 	if (!target) goto parseCastExprNodeAbort;
 
-	/* Optionally parse the cast-to token */
-	status = acceptToken(&tokens, TT_A);
+	/* Wrap the expression in one cast per cast token; the types appear
+	 * innermost-first in the token stream */
+	while (depth--) {
+		/* Optionally parse the cast-to token */
+		acceptToken(&tokens, TT_A);
 
-	/* Parse the type to cast to */
-	newtype = parseTypeNode(&tokens);
-	if (!newtype) goto parseCastExprNodeAbort;
+		/* Parse the type to cast to */
+		newtype = parseTypeNode(&tokens);
+		if (!newtype) goto parseCastExprNodeAbort;
 
-	/* Create the new CastExprNode structure */
-	expr = createCastExprNode(target, newtype);
-	if (!expr) goto parseCastExprNodeAbort;
+		/* Create the new CastExprNode structure (the type is copied
+		 * into it by value) */
+		expr = createCastExprNode(target, newtype);
+		if (!expr) goto parseCastExprNodeAbort;
+		deleteTypeNode(newtype);
+		newtype = NULL;
 
-	/* Create the new ExprNode structure */
-	ret = createExprNode(ET_CAST, expr);
-	if (!ret) goto parseCastExprNodeAbort;
+		/* Create the new ExprNode structure */
+		ret = createExprNode(ET_CAST, expr);
+		if (!ret) goto parseCastExprNodeAbort;
+		expr = NULL;
+
+		/* The cast becomes the target of the next, outer cast */
+		target = ret;
+	}
 
 	/* Since we're successful, update the token stream */
 	*tokenp = tokens;
@@ -1856,12 +1757,9 @@ ExprNode *parseCastExprNode(Token ***tokenp)
 parseCastExprNodeAbort: /* Exception handling */
 
 	/* Clean up any allocated structures */
-	if (ret) deleteExprNode(ret);
-	else if (expr) deleteCastExprNode(expr);
-	else {
-		if (newtype) deleteTypeNode(newtype);
-		if (target) deleteExprNode(target);
-	}
+	if (newtype) deleteTypeNode(newtype);
+	if (expr) deleteCastExprNode(expr);
+	else if (target) deleteExprNode(target);
 
 	return NULL;
 }
@@ -1885,9 +1783,7 @@ ExprNode *parseConstantExprNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ET_CONSTANT");
-#endif
 
 	/* Parse the constant */
 	node = parseConstantNode(&tokens);
@@ -1932,9 +1828,7 @@ ExprNode *parseIdentifierExprNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ET_IDENTIFIER");
-#endif
 
 	/* Parse the identifier node */
 	node = parseIdentifierNode(&tokens);
@@ -1984,20 +1878,14 @@ ExprNode *parseFuncCallExprNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ET_FUNCCALL");
-#endif
 
 	/* Parse the scope name */
 	scope = parseIdentifierNode(&tokens);
 	if (!scope) goto parseFuncCallExprNodeAbort;
 
 	/* Parse the function call token */
-	status = acceptToken(&tokens, TT_IZ);
-	if (!status) {
-		parser_error_expected_token(TT_IZ, tokens);
-		goto parseFuncCallExprNodeAbort;
-	}
+	EXPECT_TOKEN(TT_IZ, parseFuncCallExprNodeAbort);
 
 	/* Parse the function name */
 	name = parseIdentifierNode(&tokens);
@@ -2032,11 +1920,7 @@ ExprNode *parseFuncCallExprNode(Token ***tokenp)
 	}
 
 	/* Parse the end-of-argument token */
-	status = acceptToken(&tokens, TT_MKAY);
-	if (!status) {
-		parser_error_expected_token(TT_MKAY, tokens);
-		goto parseFuncCallExprNodeAbort;
-	}
+	EXPECT_TOKEN(TT_MKAY, parseFuncCallExprNodeAbort);
 
 	/* Create the new FuncCallExprNode structure */
 	expr = createFuncCallExprNode(scope, name, args);
@@ -2066,6 +1950,65 @@ parseFuncCallExprNodeAbort: /* Exception handling */
 	return NULL;
 }
 
+/**
+ * Represents the number of arguments an operation takes.
+ */
+typedef enum {
+	AT_NONE,   /**< Not an operation token. */
+	AT_UNARY,  /**< One argument. */
+	AT_BINARY, /**< Two arguments. */
+	AT_NARY    /**< Any number of arguments. */
+} OpArity;
+
+/**
+ * The operation tokens the parser understands, as (token, operation, arity)
+ * triples.  The lookup tables used by parseOpExprNode and the debug trace
+ * strings are all generated from this single list.
+ */
+#define PARSER_OP_LIST(X) \
+	/* Unary operations */ \
+	X(TT_NOT,         OP_NOT,  AT_UNARY) \
+	/* Binary operations */ \
+	X(TT_SUMOF,       OP_ADD,  AT_BINARY) \
+	X(TT_DIFFOF,      OP_SUB,  AT_BINARY) \
+	X(TT_PRODUKTOF,   OP_MULT, AT_BINARY) \
+	X(TT_QUOSHUNTOF,  OP_DIV,  AT_BINARY) \
+	X(TT_MODOF,       OP_MOD,  AT_BINARY) \
+	X(TT_BIGGROF,     OP_MAX,  AT_BINARY) \
+	X(TT_SMALLROF,    OP_MIN,  AT_BINARY) \
+	X(TT_BOTHOF,      OP_AND,  AT_BINARY) \
+	X(TT_EITHEROF,    OP_OR,   AT_BINARY) \
+	X(TT_WONOF,       OP_XOR,  AT_BINARY) \
+	X(TT_BOTHSAEM,    OP_EQ,   AT_BINARY) \
+	X(TT_DIFFRINT,    OP_NEQ,  AT_BINARY) \
+	/* N-ary operations */ \
+	X(TT_ALLOF,       OP_AND,  AT_NARY) \
+	X(TT_ANYOF,       OP_OR,   AT_NARY) \
+	X(TT_SMOOSH,      OP_CAT,  AT_NARY)
+
+/** The operation performed by each operation token. */
+static const OpType parserOpType[TT_ENDOFTOKENS + 1] = {
+#define X(tt, op, ar) [tt] = op,
+	PARSER_OP_LIST(X)
+#undef X
+};
+
+/** The arity of each operation token (AT_NONE for all other tokens). */
+static const OpArity parserOpArity[TT_ENDOFTOKENS + 1] = {
+#define X(tt, op, ar) [tt] = ar,
+	PARSER_OP_LIST(X)
+#undef X
+};
+
+#ifdef DEBUG
+/** The debug trace string for each operation token. */
+static const char *parserOpName[TT_ENDOFTOKENS + 1] = {
+#define X(tt, op, ar) [tt] = "ET_OP (" #op ")",
+	PARSER_OP_LIST(X)
+#undef X
+};
+#endif
+
 /**
  * Parses tokens into an operation expression.
  *
@@ -2079,12 +2022,7 @@ parseFuncCallExprNodeAbort: /* Exception handling */
  */
 ExprNode *parseOpExprNode(Token ***tokenp)
 {
-	enum ArityType {
-		AT_UNARY,
-		AT_BINARY,
-		AT_NARY
-	};
-	enum ArityType arity;
+	OpArity arity;
 	ExprNodeList *args = NULL;
 	ExprNode *arg = NULL;
 	OpExprNode *expr = NULL;
@@ -2095,125 +2033,19 @@ ExprNode *parseOpExprNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-	/* Unary operations */
-	if (acceptToken(&tokens, TT_NOT)) {
-		type = OP_NOT;
-		arity = AT_UNARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_NOT)");
-#endif
-	}
-	/* Binary operations */
-	else if (acceptToken(&tokens, TT_SUMOF)) {
-		type = OP_ADD;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_ADD)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_DIFFOF)) {
-		type = OP_SUB;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_SUB)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_PRODUKTOF)) {
-		type = OP_MULT;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_MULT)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_QUOSHUNTOF)) {
-		type = OP_DIV;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_DIV)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_MODOF)) {
-		type = OP_MOD;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_MOD)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_BIGGROF)) {
-		type = OP_MAX;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_MAX)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_SMALLROF)) {
-		type = OP_MIN;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_MIN)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_BOTHOF)) {
-		type = OP_AND;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_AND)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_EITHEROF)) {
-		type = OP_OR;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_OR)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_WONOF)) {
-		type = OP_XOR;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_XOR)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_BOTHSAEM)) {
-		type = OP_EQ;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_EQ)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_DIFFRINT)) {
-		type = OP_NEQ;
-		arity = AT_BINARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_NEQ)");
-#endif
-	}
-	/* N-ary operators */
-	else if (acceptToken(&tokens, TT_ALLOF)) {
-		type = OP_AND;
-		arity = AT_NARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_AND)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_ANYOF)) {
-		type = OP_OR;
-		arity = AT_NARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_OR)");
-#endif
-	}
-	else if(acceptToken(&tokens, TT_SMOOSH)) {
-		type = OP_CAT;
-		arity = AT_NARY;
-#ifdef DEBUG
-		debug("ET_OP (OP_CAT)");
-#endif
-	}
-	else {
+	/* Read the operation token once; the double indirection through the
+	 * cursor defeats the optimizer otherwise */
+	Token *cur = *tokens;
+
+	/* Look up the operation token */
+	arity = parserOpArity[cur->type];
+	if (arity == AT_NONE) {
 		parser_error(PR_INVALID_OPERATOR, tokens);
 		return NULL;
 	}
+	type = parserOpType[cur->type];
+	debug(parserOpName[cur->type]);
+	tokens++;
 
 	/* Create the argument list */
 	args = createExprNodeList();
@@ -2241,7 +2073,7 @@ ExprNode *parseOpExprNode(Token ***tokenp)
 		arg = NULL;
 
 		/* Optionally parse the argument-separator token */
-		status = acceptToken(&tokens, TT_AN);
+		acceptToken(&tokens, TT_AN);
 
 		/* Parse the second argument */
 		arg = parseExprNode(&tokens);
@@ -2263,12 +2095,16 @@ ExprNode *parseOpExprNode(Token ***tokenp)
 			status = addExprNode(args, arg);
 			if (!status) goto parseOpExprNodeAbort;
 			arg = NULL;
-			
-			/* Stop if the end-of-arguments token is present */
-			if (acceptToken(&tokens, TT_MKAY)) break;
 
-			/* Optionally parse the argument-separator token */
-			status = acceptToken(&tokens, TT_AN);
+			/* Check both the end-of-arguments token and the
+			 * optional argument-separator token against a single
+			 * read of the current token */
+			cur = *tokens;
+			if (cur->type == TT_MKAY) {
+				tokens++;
+				break;
+			}
+			if (cur->type == TT_AN) tokens++;
 		}
 	}
 
@@ -2314,9 +2150,7 @@ ExprNode *parseExprNode(Token ***tokenp)
 	Token **tokens = *tokenp;
 	ExprNode *ret = NULL;
 
-#ifdef DEBUG
 	shiftout();
-#endif
 
 	/* Parse context-sensitive expressions */
 	if (peekToken(&tokens, TT_IDENTIFIER)
@@ -2370,9 +2204,7 @@ ExprNode *parseExprNode(Token ***tokenp)
 	}
 	/* Implicit variable */
 	else if (acceptToken(&tokens, TT_IT)) {
-#ifdef DEBUG
 		debug("ET_IMPVAR");
-#endif
 
 		/* Create the new ExprNode structure */
 		ret = createExprNode(ET_IMPVAR, NULL);
@@ -2385,9 +2217,7 @@ ExprNode *parseExprNode(Token ***tokenp)
 		parser_error(PR_EXPECTED_EXPRESSION, tokens);
 	}
 
-#ifdef DEBUG
 	shiftin();
-#endif
 
 	return ret;
 }
@@ -2409,40 +2239,32 @@ StmtNode *parseCastStmtNode(Token ***tokenp)
 	TypeNode *newtype = NULL;
 	CastStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_CAST");
-#endif
 
 	/* Parse the target of the cast statement */
 	target = parseIdentifierNode(&tokens);
 	if (!target) goto parseCastStmtNodeAbort;
 
 	/* Remove the cast keywords from the token stream */
-	status = acceptToken(&tokens, TT_ISNOWA);
-	if (!status) {
-		parser_error_expected_token(TT_ISNOWA, tokens);
-		goto parseCastStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_ISNOWA, parseCastStmtNodeAbort);
 
 	/* Parse the type to cast to */
 	newtype = parseTypeNode(&tokens);
 	if (!newtype) goto parseCastStmtNodeAbort;
 
 	/* Make sure the statement ends with a newline */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseCastStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseCastStmtNodeAbort);
 
-	/* Create the new CastStmtNode structure */
+	/* Create the new CastStmtNode structure (the type is copied into it
+	 * by value) */
 	stmt = createCastStmtNode(target, newtype);
 	if (!stmt) goto parseCastStmtNodeAbort;
+	deleteTypeNode(newtype);
+	newtype = NULL;
 
 	/* Create the new StmtNode structure */
 	ret = createStmtNode(ST_CAST, stmt);
@@ -2490,9 +2312,7 @@ StmtNode *parsePrintStmtNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_PRINT");
-#endif
 
 	/**
 	 * Remove the print keyword from the token stream
@@ -2513,6 +2333,8 @@ StmtNode *parsePrintStmtNode(Token ***tokenp)
 	args = createExprNodeList();
 	if (!args) goto parsePrintStmtNodeAbort;
 	do {
+		Token *cur;
+
 		/* Parse an argument; it should be an expression */
 		arg = parseExprNode(&tokens);
 		if (!arg) goto parsePrintStmtNodeAbort;
@@ -2522,20 +2344,18 @@ StmtNode *parsePrintStmtNode(Token ***tokenp)
 		if (!status) goto parsePrintStmtNodeAbort;
 		arg = NULL;
 
-		/* Arguments can optionally be separated by an AN keyword */
-		status = acceptToken(&tokens, TT_AN);
-	} while (!peekToken(&tokens, TT_NEWLINE)
-			&& !peekToken(&tokens, TT_BANG));
+		/* Consume an optional AN separator and check both
+		 * terminators while reading each token only once */
+		cur = *tokens;
+		if (cur->type == TT_AN) cur = *++tokens;
+		if (cur->type == TT_NEWLINE || cur->type == TT_BANG) break;
+	} while (1);
 
 	/* Check for the no-newline token */
 	if (acceptToken(&tokens, TT_BANG)) nonl = 1;
 
 	/* Make sure the statement ends with a newline */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parsePrintStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parsePrintStmtNodeAbort);
 
 	/* Create the new PrintStmtNode structure */
 	stmt = createPrintStmtNode(args, file, nonl);
@@ -2579,32 +2399,21 @@ StmtNode *parseInputStmtNode(Token ***tokenp)
 	IdentifierNode *target = NULL;
 	InputStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_INPUT");
-#endif
 
 	/* Remove the input keyword from the token stream */
-	status = acceptToken(&tokens, TT_GIMMEH);
-	if (!status) {
-		parser_error_expected_token(TT_GIMMEH, tokens);
-		goto parseInputStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_GIMMEH, parseInputStmtNodeAbort);
 
 	/* Parse the identifier to store the input into */
 	target = parseIdentifierNode(&tokens);
 	if (!target) goto parseInputStmtNodeAbort;
 
 	/* Make sure the statement ends with a newline */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseInputStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseInputStmtNodeAbort);
 
 	/* Create the new InputStmtNode structure */
 	stmt = createInputStmtNode(target);
@@ -2648,14 +2457,11 @@ StmtNode *parseAssignmentStmtNode(Token ***tokenp)
 	ExprNode *expr = NULL;
 	AssignmentStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_ASSIGNMENT");
-#endif
 
 	/* Parse the target of the assignment */
 	target = parseIdentifierNode(&tokens);
@@ -2671,12 +2477,8 @@ StmtNode *parseAssignmentStmtNode(Token ***tokenp)
 	expr = parseExprNode(&tokens);
 	if (!expr) goto parseAssignmentStmtNodeAbort;
 
-	/* Make sure the statement ends with a newline */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseAssignmentStmtNodeAbort;
-	}
+	/* Make sure the statement ends with a newline */
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseAssignmentStmtNodeAbort);
 
 	/* Create the new AssignmentStmtNode structure */
 	stmt = createAssignmentStmtNode(target, expr);
@@ -2729,9 +2531,7 @@ StmtNode *parseDeclarationStmtNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_DECLARATION");
-#endif
 
 	/* Parse the scope to declare the variable in */
 	scope = parseIdentifierNode(&tokens);
@@ -2769,11 +2569,7 @@ StmtNode *parseDeclarationStmtNode(Token ***tokenp)
 	}
 
 	/* Make sure the statement ends with a newline */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseDeclarationStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseDeclarationStmtNodeAbort);
 
 	/* Create the new DeclarationStmtNode structure */
 	stmt = createDeclarationStmtNode(scope, target, expr, type, parent);
@@ -2829,36 +2625,19 @@ StmtNode *parseIfThenElseStmtNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_CONDITIONAL");
-#endif
 
 	/* Remove the if keyword from the token stream */
-	status = acceptToken(&tokens, TT_ORLY);
-	if (!status) {
-		parser_error_expected_token(TT_ORLY, tokens);
-		goto parseIfThenElseStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_ORLY, parseIfThenElseStmtNodeAbort);
 
 	/* The if keyword must appear on its own line */
-	if (!acceptToken(&tokens, TT_NEWLINE)) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseIfThenElseStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseIfThenElseStmtNodeAbort);
 
 	/* Parse the true branch keyword */
-	status = acceptToken(&tokens, TT_YARLY);
-	if (!status) {
-		parser_error_expected_token(TT_YARLY, tokens);
-		goto parseIfThenElseStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_YARLY, parseIfThenElseStmtNodeAbort);
 
 	/* The true branch keyword must appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseIfThenElseStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseIfThenElseStmtNodeAbort);
 
 	/* Parse the true part of the branch */
 	yes = parseBlockNode(&tokens);
@@ -2882,11 +2661,7 @@ StmtNode *parseIfThenElseStmtNode(Token ***tokenp)
 		guard = NULL;
 
 		/* The else-if keyword and guard must be on their own line */
-		status = acceptToken(&tokens, TT_NEWLINE);
-		if (!status) {
-			parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-			goto parseIfThenElseStmtNodeAbort;
-		}
+		EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseIfThenElseStmtNodeAbort);
 
 		/* Parse the else-if block */
 		block = parseBlockNode(&tokens);
@@ -2901,11 +2676,7 @@ StmtNode *parseIfThenElseStmtNode(Token ***tokenp)
 	/* Parse the else keyword */
 	if (acceptToken(&tokens, TT_NOWAI)) {
 		/* The else keyword must appear on its own line */
-		status = acceptToken(&tokens, TT_NEWLINE);
-		if (!status) {
-			parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-			goto parseIfThenElseStmtNodeAbort;
-		}
+		EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseIfThenElseStmtNodeAbort);
 
 		/* Parse the else block */
 		no = parseBlockNode(&tokens);
@@ -2913,18 +2684,10 @@ StmtNode *parseIfThenElseStmtNode(Token ***tokenp)
 	}
 
 	/* Parse the end-if-block keyword */
-	status = acceptToken(&tokens, TT_OIC);
-	if (!status) {
-		parser_error_expected_token(TT_OIC, tokens);
-		goto parseIfThenElseStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_OIC, parseIfThenElseStmtNodeAbort);
 
 	/* The end-if-block keyword must appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseIfThenElseStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseIfThenElseStmtNodeAbort);
 
 	/* Create the new IfThenElseStmtNode structure */
 	stmt = createIfThenElseStmtNode(yes, no, guards, blocks);
@@ -2956,6 +2719,167 @@ parseIfThenElseStmtNodeAbort: /* Exception handling */
 	return NULL;
 }
 
+/**
+ * Stores the set of constants already used as guards by a switch statement.
+ * Used by parseSwitchStmtNode to check literal uniqueness in constant time
+ * instead of scanning all previous guards.  The types and comparison keys
+ * are kept in arrays parallel to the guards themselves so that probes stay
+ * within the table instead of chasing node pointers.  The set holds borrowed
+ * pointers; the guards are owned by the statement's guard list.
+ */
+typedef struct {
+	unsigned char *types; /**< The constant types of the stored guards. */
+	uint64_t *keys;       /**< The comparison keys of the stored guards. */
+	ConstantNode **slots; /**< The stored guards (\c NULL marks empty). */
+	unsigned int num;     /**< The number of constants stored. */
+	unsigned int cap;     /**< The number of slots (a power of two). */
+} GuardSet;
+
+/**
+ * Computes the comparison key of a guard constant.  Keys compare exactly:
+ * boolean and integer guards use their values and string guards use their
+ * addresses, which identify their contents because string constants are
+ * interned (see internParserString).
+ *
+ * \param [in] c The constant to compute the key of.
+ *
+ * \return The comparison key of \a c.
+ */
+static uint64_t guardKey(ConstantNode *c)
+{
+	if (c->type == CT_STRING) return (uint64_t)(uintptr_t)c->data.s;
+	return (uint64_t)c->data.i;
+}
+
+/**
+ * Computes the slot a guard probes first.
+ *
+ * \param [in] type The constant type of the guard.
+ *
+ * \param [in] key The comparison key of the guard.
+ *
+ * \param [in] cap The number of slots in the set (a power of two).
+ *
+ * \return The first slot to probe.
+ */
+static unsigned int guardBucket(unsigned char type,
+                                uint64_t key,
+                                unsigned int cap)
+{
+	uint64_t hash = (key ^ type) * 11400714819323198485ull;
+	return (unsigned int)(hash >> 32) & (cap - 1);
+}
+
+/**
+ * Checks if an equivalent constant is in a guard set.
+ *
+ * \param [in] set The guard set to probe.
+ *
+ * \param [in] c The constant to look for.
+ *
+ * \param [in] key The comparison key of \a c (see guardKey).
+ *
+ * \retval 0 No equivalent constant is in \a set.
+ *
+ * \retval 1 An equivalent constant is in \a set.
+ */
+static int guardSetContains(GuardSet *set,
+                            ConstantNode *c,
+                            uint64_t key)
+{
+	unsigned int n;
+	if (!set->cap) return 0;
+	for (n = guardBucket(c->type, key, set->cap);
+			set->slots[n];
+			n = (n + 1) & (set->cap - 1)) {
+		if (set->types[n] != (unsigned char)c->type) continue;
+		if (set->keys[n] != key) continue;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Adds a constant to a guard set, growing the set as needed.
+ *
+ * \param [in,out] set The guard set to add \a c to.
+ *
+ * \param [in] c The constant to add.
+ *
+ * \param [in] key The comparison key of \a c (see guardKey).
+ *
+ * \retval 0 Memory allocation failed.
+ *
+ * \retval 1 \a c was added to \a set.
+ */
+static int guardSetInsert(GuardSet *set,
+                          ConstantNode *c,
+                          uint64_t key)
+{
+	unsigned int n;
+	/* Keep the set at most half full */
+	if ((set->num + 1) * 2 > set->cap) {
+		unsigned int newcap = set->cap ? set->cap * 2 : 16;
+		unsigned char *types = calloc(newcap, sizeof(unsigned char));
+		uint64_t *keys = calloc(newcap, sizeof(uint64_t));
+		ConstantNode **slots = calloc(newcap, sizeof(ConstantNode *));
+		if (!types || !keys || !slots) {
+			perror("calloc");
+			free(types);
+			free(keys);
+			free(slots);
+			return 0;
+		}
+		for (n = 0; n < set->cap; n++) {
+			unsigned int m;
+			if (!set->slots[n]) continue;
+			for (m = guardBucket(set->types[n], set->keys[n], newcap);
+					slots[m];
+					m = (m + 1) & (newcap - 1));
+			types[m] = set->types[n];
+			keys[m] = set->keys[n];
+			slots[m] = set->slots[n];
+		}
+		free(set->types);
+		free(set->keys);
+		free(set->slots);
+		set->types = types;
+		set->keys = keys;
+		set->slots = slots;
+		set->cap = newcap;
+	}
+	for (n = guardBucket(c->type, key, set->cap);
+			set->slots[n];
+			n = (n + 1) & (set->cap - 1));
+	set->types[n] = (unsigned char)c->type;
+	set->keys[n] = key;
+	set->slots[n] = c;
+	set->num++;
+	return 1;
+}
+
+/**
+ * Checks whether a string contains an interpolation sequence.
+ *
+ * Most string literals contain no colon at all, so a single scan that only
+ * checks the following byte after finding one is cheaper than handing the
+ * general substring machinery of strstr() a two-character needle.
+ *
+ * \param [in] str The string to check.
+ *
+ * \retval 0 \a str does not contain an interpolation sequence.
+ *
+ * \retval 1 \a str contains an interpolation sequence.
+ */
+static int containsInterpolation(const char *str)
+{
+	const char *p;
+	for (p = str; *p; p++) {
+		if (*p == ':' && *(p + 1) == '{') return 1;
+	}
+	return 0;
+}
+
 /**
  * Parses tokens into a switch statement.
  *
@@ -2977,28 +2901,19 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 	BlockNode *def = NULL;
 	SwitchStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
+	GuardSet dupes = { NULL, NULL, NULL, 0, 0 };
 	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_SWITCH");
-#endif
 
 	/* Remove the switch keyword from the token stream */
-	status = acceptToken(&tokens, TT_WTF);
-	if (!status) {
-		parser_error_expected_token(TT_WTF, tokens);
-		goto parseSwitchStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_WTF, parseSwitchStmtNodeAbort);
 
 	/* The switch keyword must appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseSwitchStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseSwitchStmtNodeAbort);
 
 	/* Set up lists of guards and blocks */
 	guards = createExprNodeList();
@@ -3011,11 +2926,7 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 		unsigned int n = 0;
 
 		/* Parse the case keyword */
-		status = acceptToken(&tokens, TT_OMG);
-		if (!status) {
-			parser_error_expected_token(TT_OMG, tokens);
-			goto parseSwitchStmtNodeAbort;
-		}
+		EXPECT_TOKEN(TT_OMG, parseSwitchStmtNodeAbort);
 
 		/* Parse a constant for the case */
 		/** \note The 1.2 specification only allows constant
@@ -3025,25 +2936,33 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 		if (!c) goto parseSwitchStmtNodeAbort;
 
 		/* String interpolation is not allowed */
-		if (c->type == CT_STRING && strstr(c->data.s, ":{")) {
+		if (c->type == CT_STRING && containsInterpolation(c->data.s)) {
 			parser_error(PR_CANNOT_USE_STR_AS_LITERAL, tokens);
 			goto parseSwitchStmtNodeAbort;
 		}
 
-		/* Make sure the constant is unique to this switch statement */
-		for (n = 0; n < guards->num; n++) {
-			ConstantNode *test = guards->exprs[n]->expr;
-			if (c->type != test->type) continue;
-			/* Check for equivalent types and values */
-			if (((c->type == CT_BOOLEAN || c->type == CT_INTEGER)
-					&& c->data.i == test->data.i)
-					|| (c->type == CT_FLOAT
-					&& fabs(c->data.f - test->data.f) < FLT_EPSILON)
-					|| (c->type == CT_STRING
-					&& !strcmp(c->data.s, test->data.s))) {
+		/* Make sure the constant is unique to this switch statement.
+		 * Floats compare approximately, so they are checked against
+		 * the previous float guards; everything else probes the
+		 * guard set */
+		if (c->type == CT_FLOAT) {
+			for (n = 0; n < guards->num; n++) {
+				ConstantNode *test = getExprData(guards->exprs[n]);
+				if (test->type == CT_FLOAT
+						&& fabs(c->data.f - test->data.f) < FLT_EPSILON) {
+					parser_error(PR_LITERAL_MUST_BE_UNIQUE, tokens);
+					goto parseSwitchStmtNodeAbort;
+				}
+			}
+		}
+		else {
+			uint64_t key = guardKey(c);
+			if (guardSetContains(&dupes, c, key)) {
 				parser_error(PR_LITERAL_MUST_BE_UNIQUE, tokens);
 				goto parseSwitchStmtNodeAbort;
 			}
+			status = guardSetInsert(&dupes, c, key);
+			if (!status) goto parseSwitchStmtNodeAbort;
 		}
 
 		/* Package the constant in an expression */
@@ -3056,11 +2975,7 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 		guard = NULL;
 
 		/* Make sure the guard appears on its own line */
-		status = acceptToken(&tokens, TT_NEWLINE);
-		if (!status) {
-			parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-			goto parseSwitchStmtNodeAbort;
-		}
+		EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseSwitchStmtNodeAbort);
 
 		/* Parse the block associated with the guard */
 		block = parseBlockNode(&tokens);
@@ -3075,11 +2990,7 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 	/* Check for the default case */
 	if (acceptToken(&tokens, TT_OMGWTF)) {
 		/* Make sure the default case keyword appears on its own line */
-		status = acceptToken(&tokens, TT_NEWLINE);
-		if (!status) {
-			parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-			goto parseSwitchStmtNodeAbort;
-		}
+		EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseSwitchStmtNodeAbort);
 
 		/* Parse the default case block */
 		def = parseBlockNode(&tokens);
@@ -3087,18 +2998,10 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 	}
 
 	/* Parse the end-switch keyword */
-	status = acceptToken(&tokens, TT_OIC);
-	if (!status) {
-		parser_error_expected_token(TT_OIC, tokens);
-		goto parseSwitchStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_OIC, parseSwitchStmtNodeAbort);
 
 	/* Make sure the end-switch keyword appears on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseSwitchStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseSwitchStmtNodeAbort);
 
 	/* Create the new SwitchStmtNode structure */
 	stmt = createSwitchStmtNode(guards, blocks, def);
@@ -3111,11 +3014,18 @@ StmtNode *parseSwitchStmtNode(Token ***tokenp)
 	/* Since we're successful, update the token stream */
 	*tokenp = tokens;
 
+	free(dupes.types);
+	free(dupes.keys);
+	free(dupes.slots);
+
 	return ret;
 
 parseSwitchStmtNodeAbort: /* Exception handling */
 
 	/* Clean up any allocated structures */
+	free(dupes.types);
+	free(dupes.keys);
+	free(dupes.slots);
 	if (ret) deleteStmtNode(ret);
 	else if (stmt) deleteSwitchStmtNode(stmt);
 	else {
@@ -3144,28 +3054,17 @@ parseSwitchStmtNodeAbort: /* Exception handling */
 StmtNode *parseBreakStmtNode(Token ***tokenp)
 {
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_BREAK");
-#endif
 
 	/* Remove the break keyword from the token stream */
-	status = acceptToken(&tokens, TT_GTFO);
-	if (!status) {
-		parser_error_expected_token(TT_GTFO, tokens);
-		goto parseBreakStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_GTFO, parseBreakStmtNodeAbort);
 
 	/* The break keyword must appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseBreakStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseBreakStmtNodeAbort);
 
 	/* Create the new StmtNode structure */
 	ret = createStmtNode(ST_BREAK, NULL);
@@ -3199,32 +3098,21 @@ StmtNode *parseReturnStmtNode(Token ***tokenp)
 	ExprNode *value = NULL;
 	ReturnStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_RETURN");
-#endif
 
 	/* Remove the return keyword from the token stream */
-	status = acceptToken(&tokens, TT_FOUNDYR);
-	if (!status) {
-		parser_error_expected_token(TT_FOUNDYR, tokens);
-		goto parseReturnStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_FOUNDYR, parseReturnStmtNodeAbort);
 
 	/* Parse the return value */
 	value = parseExprNode(&tokens);
 	if (!value) goto parseReturnStmtNodeAbort;
 
 	/* The return statement must reside on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseReturnStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseReturnStmtNodeAbort);
 
 	/* Create the new ReturnStmtNode structure */
 	stmt = createReturnStmtNode(value);
@@ -3272,12 +3160,10 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 	IdentifierNode *name2 = NULL;
 	LoopStmtNode *stmt = NULL;
 	ExprNodeList *args = NULL;
-	char *id = NULL;
 
 	/* For increment and decrement loops */
 	IdentifierNode *varcopy = NULL;
 	ExprNode *arg1 = NULL;
-	ConstantNode *one = NULL;
 	ExprNode *arg2 = NULL;
 	OpExprNode *op = NULL;
 
@@ -3288,9 +3174,7 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 	ExprNode *arg = NULL;
 
 	/* For loop predicates */
-	ExprNode *predarg = NULL;
-	ExprNodeList *predargs = NULL;
-	OpExprNode *predop = NULL;
+	int invert = 0;
 
 	StmtNode *ret = NULL;
 	int status;
@@ -3298,16 +3182,10 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_LOOP");
-#endif
 
 	/* Remove the loop-start keyword from the token stream */
-	status = acceptToken(&tokens, TT_IMINYR);
-	if (!status) {
-		parser_error_expected_token(TT_IMINYR, tokens);
-		goto parseLoopStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_IMINYR, parseLoopStmtNodeAbort);
 
 	/* Parse the loop name */
 	name1 = parseIdentifierNode(&tokens);
@@ -3324,17 +3202,13 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 		/* Parse the increment token or decrement token */
 		if (acceptToken(&tokens, TT_UPPIN)) {
 			type = OP_ADD;
-#ifdef DEBUG
 			shiftout();
 			debug("ET_OP (OP_ADD)");
-#endif
 		}
 		else if (acceptToken(&tokens, TT_NERFIN)) {
 			type = OP_SUB;
-#ifdef DEBUG
 			shiftout();
 			debug("ET_OP (OP_SUB)");
-#endif
 		}
 		else {
 			parser_error_expected_either_token(TT_UPPIN, TT_NERFIN, tokens);
@@ -3350,30 +3224,27 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 		/* Parse the variable to operate on */
 		var = parseIdentifierNode(&tokens);
 		if (!var) goto parseLoopStmtNodeAbort;
-#ifdef DEBUG
 		shiftout();
 		debug("ET_CONSTANT (CT_INTEGER)");
 		shiftin();
 		shiftin();
-#endif
-		/* Make a copy of the variable for use as a function argument */
-		id = malloc(sizeof(char) * (strlen(var->id) + 1));
-		if (!id) goto parseLoopStmtNodeAbort;
-		strcpy(id, var->id);
-		varcopy = createIdentifierNode(IT_DIRECT, id, NULL, var->fname, var->line);
-		if (!varcopy) goto parseLoopStmtNodeAbort;
-		id = NULL;
+		/* The variable doubles as the function argument; identifier
+		 * nodes are immutable once parsed and live in the arena, so
+		 * the node can be shared instead of copied */
+		varcopy = var;
 
 		/* Package the variable into an identifier expression */
 		arg1 = createExprNode(ET_IDENTIFIER, varcopy);
 		if (!arg1) goto parseLoopStmtNodeAbort;
 
-		/* Create a constant integer "1" */
-		one = createIntegerConstantNode(1);
-		if (!one) goto parseLoopStmtNodeAbort;
-
-		/* Package the constant into an expression */
-		arg2 = createExprNode(ET_CONSTANT, one);
+		/* Reuse the canonical constant integer "1" expression,
+		 * creating it on first use */
+		if (!parserOneExpr) {
+			ConstantNode *one = createIntegerConstantNode(1);
+			if (!one) goto parseLoopStmtNodeAbort;
+			parserOneExpr = createExprNode(ET_CONSTANT, one);
+		}
+		arg2 = parserOneExpr;
 		if (!arg2) goto parseLoopStmtNodeAbort;
 
 		/* Create a list of arguments */
@@ -3399,19 +3270,13 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 	/* Check if a function loop */
 	else if (nextToken(&tokens, TT_IZ)) {
 		IdentifierNode *temp = NULL;
-#ifdef DEBUG
 		debug("ET_FUNCCALL");
-#endif
 		/* Parse the function scope */
 		scope = parseIdentifierNode(&tokens);
 		if (!scope) goto parseLoopStmtNodeAbort;
 
 		/* Parse the function indicator */
-		status = acceptToken(&tokens, TT_IZ);
-		if (!status) {
-			parser_error_expected_token(TT_IZ, tokens);
-			goto parseLoopStmtNodeAbort;
-		}
+		EXPECT_TOKEN(TT_IZ, parseLoopStmtNodeAbort);
 
 		/* Parse the function name */
 		name = parseIdentifierNode(&tokens);
@@ -3422,18 +3287,14 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 		if (!args) goto parseLoopStmtNodeAbort;
 
 		/* Check for unary function */
-		status = acceptToken(&tokens, TT_YR);
-		if (!status) {
-			parser_error(PR_EXPECTED_UNARY_FUNCTION, tokens);
-			goto parseLoopStmtNodeAbort;
-		}
+		EXPECT_TOKEN_ERROR(TT_YR, PR_EXPECTED_UNARY_FUNCTION, parseLoopStmtNodeAbort);
 
 		/* Parse the unary function's single argument */
 		arg = parseExprNode(&tokens);
 		if (!arg) goto parseLoopStmtNodeAbort;
 
 		/* Make sure the argument is an identifier */
-		if (arg->type != ET_IDENTIFIER) {
+		if (getExprType(arg) != ET_IDENTIFIER) {
 			parser_error(PR_EXPECTED_IDENTIFIER, tokens);
 			goto parseLoopStmtNodeAbort;
 		}
@@ -3442,23 +3303,16 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 		status = addExprNode(args, arg);
 		if (!status) goto parseLoopStmtNodeAbort;
 		/* (Save a pointer to its expression for use, below) */
-		temp = (IdentifierNode *)(arg->expr);
+		temp = (IdentifierNode *)getExprData(arg);
 		arg = NULL;
 
-		/* Copy the identifier to make it the loop variable */
-		id = malloc(sizeof(char) * (strlen(temp->id) + 1));
-		if (!id) goto parseLoopStmtNodeAbort;
-		strcpy(id, temp->id);
-		var = createIdentifierNode(IT_DIRECT, id, NULL, temp->fname, temp->line);
-		if (!var) goto parseLoopStmtNodeAbort;
-		id = NULL;
+		/* The function argument doubles as the loop variable;
+		 * identifier nodes are immutable once parsed and live in the
+		 * arena, so the node can be shared instead of copied */
+		var = temp;
 
 		/* Check for unary function */
-		status = acceptToken(&tokens, TT_MKAY);
-		if (!status) {
-			parser_error_expected_token(TT_MKAY, tokens);
-			goto parseLoopStmtNodeAbort;
-		}
+		EXPECT_TOKEN(TT_MKAY, parseLoopStmtNodeAbort);
 
 		/* Create a function call expression */
 		node = createFuncCallExprNode(scope, name, args);
@@ -3479,52 +3333,24 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 		}
 		/* Check for an until token */
 		else if (acceptToken(&tokens, TT_TIL)) {
-#ifdef DEBUG
-			shiftout();
-			debug("ET_OP (OP_NOT)");
-#endif
-			/* Parse the until predicate */
-			predarg = parseExprNode(&tokens);
-			if (!predarg) goto parseLoopStmtNodeAbort;
-
-			/* Create a list for predicate arguments */
-			predargs = createExprNodeList();
-			if (!predargs) goto parseLoopStmtNodeAbort;
-
-			/* Add the until predicate to the list */
-			status = addExprNode(predargs, predarg);
-			if (!status) goto parseLoopStmtNodeAbort;
-			predarg = NULL;
-#ifdef DEBUG
-			shiftin();
-#endif
-			/* Create a NOT operation with the predicate */
-			predop = createOpExprNode(OP_NOT, predargs);
-			if (!predop) goto parseLoopStmtNodeAbort;
-
-			/* Package the NOT operation in an expression */
-			guard = createExprNode(ET_OP, predop);
+			/* Parse the until predicate; rather than wrapping it
+			 * in a NOT operation, store it directly and have the
+			 * interpreter invert its result */
+			guard = parseExprNode(&tokens);
 			if (!guard) goto parseLoopStmtNodeAbort;
+			invert = 1;
 		}
 	}
 
 	/* All of the above should be on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseLoopStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseLoopStmtNodeAbort);
 
 	/* Parse the body of the loop */
 	body = parseBlockNode(&tokens);
 	if (!body) goto parseLoopStmtNodeAbort;
 
 	/* Parse the end-loop keywords */
-	status = acceptToken(&tokens, TT_IMOUTTAYR);
-	if (!status) {
-		parser_error_expected_token(TT_IMOUTTAYR, tokens);
-		goto parseLoopStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_IMOUTTAYR, parseLoopStmtNodeAbort);
 
 	/* Parse the end-of-loop name */
 	name2 = parseIdentifierNode(&tokens);
@@ -3534,8 +3360,10 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 		goto parseLoopStmtNodeAbort;
 	}
 
-	/* Make sure the beginning-of-loop and end-of-loop names match */
-	if (strcmp((char *)(name1->id), (char *)(name2->id))) {
+	/* Make sure the beginning-of-loop and end-of-loop names match;
+	 * direct identifier names are interned, so comparing their addresses
+	 * suffices */
+	if (name1->id != name2->id) {
 		parser_error(PR_EXPECTED_MATCHING_LOOP_NAME, tokens);
 		goto parseLoopStmtNodeAbort;
 	}
@@ -3544,14 +3372,10 @@ StmtNode *parseLoopStmtNode(Token ***tokenp)
 	deleteIdentifierNode(name2);
 
 	/* The end-of-loop structure should appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-		goto parseLoopStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseLoopStmtNodeAbort);
 
 	/* Create the new LoopStmtNode structure */
-	stmt = createLoopStmtNode(name1, var, guard, update, body);
+	stmt = createLoopStmtNode(name1, var, guard, invert, update, body);
 	if (!stmt) goto parseLoopStmtNodeAbort;
 
 	/* Create the new StmtNode structure */
@@ -3576,13 +3400,11 @@ parseLoopStmtNodeAbort: /* Exception handling */
 		if (update) deleteExprNode(update);
 		if (var) deleteIdentifierNode(var);
 		if (name1) deleteIdentifierNode(name1);
-		if (id) free(id);
 
 		/* For increment and decrement loops */
 		if (op) deleteOpExprNode(op);
 		if (args) deleteExprNodeList(args);
 		if (arg2) deleteExprNode(arg2);
-		if (one) deleteConstantNode(one);
 		if (arg1) deleteExprNode(arg1);
 		if (varcopy) deleteIdentifierNode(varcopy);
 
@@ -3591,11 +3413,6 @@ parseLoopStmtNodeAbort: /* Exception handling */
 		if (node) deleteFuncCallExprNode(node);
 		if (name) deleteIdentifierNode(name);
 		if (scope) deleteIdentifierNode(scope);
-
-		/* For loop predicates */
-		if (predarg) deleteExprNode(predarg);
-		if (predargs) deleteExprNodeList(predargs);
-		if (predop) deleteOpExprNode(predop);
 	}
 	return NULL;
 }
@@ -3616,32 +3433,21 @@ StmtNode *parseDeallocationStmtNode(Token ***tokenp)
 	IdentifierNode *target = NULL;
 	DeallocationStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_DEALLOCATION");
-#endif
 
 	/* Parse the variable to deallocate */
 	target = parseIdentifierNode(&tokens);
 	if (!target) goto parseDeallocationStmtNodeAbort;
 
 	/* Parse the deallocation token */
-	status = acceptToken(&tokens, TT_RNOOB);
-	if (!status) {
-		parser_error_expected_token(TT_RNOOB, tokens);
-		goto parseDeallocationStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_RNOOB, parseDeallocationStmtNodeAbort);
 
 	/* The deallocation statement must reside on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseDeallocationStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseDeallocationStmtNodeAbort);
 
 	/* Create the new DeallocationStmtNode structure */
 	stmt = createDeallocationStmtNode(target);
@@ -3693,16 +3499,10 @@ StmtNode *parseFuncDefStmtNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_FUNCDEF");
-#endif
 
 	/* Parse the function definition token */
-	status = acceptToken(&tokens, TT_HOWIZ);
-	if (!status) {
-		parser_error_expected_token(TT_HOWIZ, tokens);
-		goto parseFuncDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_HOWIZ, parseFuncDefStmtNodeAbort);
 
 	/* Parse the scope to define the function in */
 	scope = parseIdentifierNode(&tokens);
@@ -3741,29 +3541,17 @@ StmtNode *parseFuncDefStmtNode(Token ***tokenp)
 	}
 
 	/* The function declaration should appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseFuncDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseFuncDefStmtNodeAbort);
 
 	/* Parse the body of the function */
 	body = parseBlockNode(&tokens);
 	if (!body) goto parseFuncDefStmtNodeAbort;
 
 	/* Parse the end-function token */
-	status = acceptToken(&tokens, TT_IFUSAYSO);
-	if (!status) {
-		parser_error_expected_token(TT_IFUSAYSO, tokens);
-		goto parseFuncDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_IFUSAYSO, parseFuncDefStmtNodeAbort);
 
 	/* The end-function token should appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseFuncDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseFuncDefStmtNodeAbort);
 
 	/* Create the new FuncDefStmtNode structure */
 	stmt = createFuncDefStmtNode(scope, name, args, body);
@@ -3812,21 +3600,14 @@ StmtNode *parseAltArrayDefStmtNode(Token ***tokenp)
 	IdentifierNode *parent = NULL;
 	AltArrayDefStmtNode *stmt = NULL;
 	StmtNode *ret = NULL;
-	int status;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	debug("ST_ALTARRAYDEF");
-#endif
 
 	/* Parse the alternate array definition token */
-	status = acceptToken(&tokens, TT_OHAIIM);
-	if (!status) {
-		parser_error_expected_token(TT_OHAIIM, tokens);
-		goto parseAltArrayDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_OHAIIM, parseAltArrayDefStmtNodeAbort);
 
 	/* Parse the array name */
 	name = parseIdentifierNode(&tokens);
@@ -3841,11 +3622,7 @@ StmtNode *parseAltArrayDefStmtNode(Token ***tokenp)
 
 	/* The alternate array definition token and name should appear on their
 	 * own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseAltArrayDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseAltArrayDefStmtNodeAbort);
 
 	/* Parse the array definition body */
 	body = parseBlockNode(&tokens);
@@ -3853,18 +3630,10 @@ StmtNode *parseAltArrayDefStmtNode(Token ***tokenp)
 
 	/* The end-alternate array definition token should appear on its own
 	 * line */
-	status = acceptToken(&tokens, TT_KTHX);
-	if (!status) {
-		parser_error_expected_token(TT_KTHX, tokens);
-		goto parseAltArrayDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN(TT_KTHX, parseAltArrayDefStmtNodeAbort);
 
 	/* The end-function token should appear on its own line */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseAltArrayDefStmtNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseAltArrayDefStmtNodeAbort);
 
 	/* Create the new AltArrayDefStmtNode structure */
 	stmt = createAltArrayDefStmtNode(name, body, parent);
@@ -3893,167 +3662,189 @@ parseAltArrayDefStmtNodeAbort: /* Exception handling */
 }
 
 /**
- * Parses tokens into a statement.
+ * Parses tokens into a bare expression statement.
  *
  * \param [in] tokenp The position in a token list to start parsing at.
  *
  * \post \a tokenp will point to the next unparsed token.
  *
- * \return A pointer to a statement.
+ * \return A pointer to an expression statement.
  *
  * \retval NULL Unable to parse.
  */
-StmtNode *parseStmtNode(Token ***tokenp)
+static StmtNode *parseExprStmtNode(Token ***tokenp)
 {
-	StmtNode *ret = NULL;
 	ExprNode *expr = NULL;
+	StmtNode *ret = NULL;
 
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
-	shiftout();
-#endif
+	debug("ST_EXPR");
 
-	/* Parse context-sensitive expressions */
-	if (peekToken(&tokens, TT_IDENTIFIER)
-			|| peekToken(&tokens, TT_SRS)) {
-		IdentifierNode *id = NULL;
+	/* Parse the expression */
+	expr = parseExprNode(&tokens);
+	if (!expr) goto parseExprStmtNodeAbort;
 
-		/* Remove the identifier from the token stream */
-		id = parseIdentifierNode(&tokens);
-		if (!id) return NULL;
+	/* The expression should appear on its own line */
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_EXPRESSION, parseExprStmtNodeAbort);
 
-		/* We do not need to hold onto it */
-		deleteIdentifierNode(id);
+	/* Create the new StmtNode structure */
+	ret = createStmtNode(ST_EXPR, expr);
+	if (!ret) goto parseExprStmtNodeAbort;
 
-		/* Casting */
-		if (peekToken(&tokens, TT_ISNOWA)) {
-			ret = parseCastStmtNode(tokenp);
-		}
-		/* Assignment */
-		else if (peekToken(&tokens, TT_R)) {
-			ret = parseAssignmentStmtNode(tokenp);
-		}
-		/* Variable declaration */
-		else if (peekToken(&tokens, TT_HASA) || peekToken(&tokens, TT_HASAN)) {
-			ret = parseDeclarationStmtNode(tokenp);
-		}
-		/* Deallocation */
-		else if (peekToken(&tokens, TT_RNOOB)) {
-			ret = parseDeallocationStmtNode(tokenp);
-		}
-		/* Bare identifier expression */
-		else {
-			/* Reset state and continue parsing */
-			tokens = *tokenp;
+	/* Since we're successful, update the token stream */
+	*tokenp = tokens;
 
-#ifdef DEBUG
-			debug("ST_EXPR");
-#endif
+	return ret;
 
-			/* Parse the expression */
-			expr = parseExprNode(&tokens);
-			if (!expr) return NULL;
+parseExprStmtNodeAbort: /* Exception handling */
 
-			/* The expression should appear on its own line */
-			if (!acceptToken(&tokens, TT_NEWLINE)) {
-				parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-				deleteExprNode(expr);
-				return NULL;
-			}
+	/* Clean up any allocated structures */
+	if (ret) deleteStmtNode(ret);
+	else if (expr) deleteExprNode(expr);
 
-			/* Create the new StmtNode structure */
-			ret = createStmtNode(ST_EXPR, expr);
-			if (!ret) {
-				deleteExprNode(expr);
-				return NULL;
-			}
+	return NULL;
+}
 
-			/* Since we're successful, update the token stream */
-			*tokenp = tokens;
-		}
-	}
-	/* Print */
-	else if (peekToken(&tokens, TT_VISIBLE)) {
-		ret = parsePrintStmtNode(tokenp);
-	}
-	/* Warn */
-	else if (peekToken(&tokens, TT_INVISIBLE)) {
-		ret = parsePrintStmtNode(tokenp);
-	}
-	/* Input */
-	else if (peekToken(&tokens, TT_GIMMEH)) {
-		ret = parseInputStmtNode(tokenp);
-	}
-	/* If/then/else */
-	else if (peekToken(&tokens, TT_ORLY)) {
-		ret = parseIfThenElseStmtNode(tokenp);
-	}
-	/* Switch */
-	else if (peekToken(&tokens, TT_WTF)) {
-		ret = parseSwitchStmtNode(tokenp);
-	}
-	/* Break */
-	else if (peekToken(&tokens, TT_GTFO)) {
-		ret = parseBreakStmtNode(tokenp);
-	}
-	/* Return */
-	else if (peekToken(&tokens, TT_FOUNDYR)) {
-		ret = parseReturnStmtNode(tokenp);
-	}
-	/* Loop */
-	else if (peekToken(&tokens, TT_IMINYR)) {
-		ret = parseLoopStmtNode(tokenp);
-	}
-	/* Function definition */
-	else if (peekToken(&tokens, TT_HOWIZ)) {
-		ret = parseFuncDefStmtNode(tokenp);
-	}
-	/* Alternate array definition */
-	else if (peekToken(&tokens, TT_OHAIIM)) {
-		ret = parseAltArrayDefStmtNode(tokenp);
-	}
-	/* Bare expression */
-	else if ((expr = parseExprNode(&tokens))) {
-		int status;
+/**
+ * Parses tokens into a statement.
+ *
+ * \param [in] tokenp The position in a token list to start parsing at.
+ *
+ * \post \a tokenp will point to the next unparsed token.
+ *
+ * \return A pointer to a statement.
+ *
+ * \retval NULL Unable to parse.
+ */
+StmtNode *parseStmtNode(Token ***tokenp)
+{
+	StmtNode *ret = NULL;
 
-#ifdef DEBUG
-		debug("ST_EXPR");
-#endif
+	/* Work from a copy of the token stream in case something goes wrong */
+	Token **tokens = *tokenp;
 
-		/* The expression should appear on its own line */
-		status = acceptToken(&tokens, TT_NEWLINE);
-		if (!status) {
-			parser_error(PR_EXPECTED_END_OF_EXPRESSION, tokens);
-			deleteExprNode(expr);
-			return NULL;
-		}
+	shiftout();
 
-		/* Create the new StmtNode structure */
-		ret = createStmtNode(ST_EXPR, expr);
-		if (!ret) {
-			deleteExprNode(expr);
-			return NULL;
+	/* Dispatch on the type of the first token; each statement type has a
+	 * distinct leading token, so a single switch replaces the chain of
+	 * peeks */
+	switch ((*tokens)->type) {
+		/* Parse context-sensitive expressions */
+		case TT_IDENTIFIER:
+		case TT_SRS: {
+			IdentifierNode *id = NULL;
+
+			/* Remove the identifier from the token stream */
+			id = parseIdentifierNode(&tokens);
+			if (!id) return NULL;
+
+			/* We do not need to hold onto it */
+			deleteIdentifierNode(id);
+
+			/* Dispatch on the token after the identifier */
+			switch ((*tokens)->type) {
+				/* Casting */
+				case TT_ISNOWA:
+					ret = parseCastStmtNode(tokenp);
+					break;
+				/* Assignment */
+				case TT_R:
+					ret = parseAssignmentStmtNode(tokenp);
+					break;
+				/* Variable declaration */
+				case TT_HASA:
+				case TT_HASAN:
+					ret = parseDeclarationStmtNode(tokenp);
+					break;
+				/* Deallocation */
+				case TT_RNOOB:
+					ret = parseDeallocationStmtNode(tokenp);
+					break;
+				/* Bare identifier expression */
+				default:
+					ret = parseExprStmtNode(tokenp);
+					break;
+			}
+			break;
 		}
-
-		/* Since we're successful, update the token stream */
-		*tokenp = tokens;
-	}
-	else {
-		parser_error(PR_EXPECTED_STATEMENT, tokens);
+		/* Print */
+		case TT_VISIBLE:
+		/* Warn */
+		case TT_INVISIBLE:
+			ret = parsePrintStmtNode(tokenp);
+			break;
+		/* Input */
+		case TT_GIMMEH:
+			ret = parseInputStmtNode(tokenp);
+			break;
+		/* If/then/else */
+		case TT_ORLY:
+			ret = parseIfThenElseStmtNode(tokenp);
+			break;
+		/* Switch */
+		case TT_WTF:
+			ret = parseSwitchStmtNode(tokenp);
+			break;
+		/* Break */
+		case TT_GTFO:
+			ret = parseBreakStmtNode(tokenp);
+			break;
+		/* Return */
+		case TT_FOUNDYR:
+			ret = parseReturnStmtNode(tokenp);
+			break;
+		/* Loop */
+		case TT_IMINYR:
+			ret = parseLoopStmtNode(tokenp);
+			break;
+		/* Function definition */
+		case TT_HOWIZ:
+			ret = parseFuncDefStmtNode(tokenp);
+			break;
+		/* Alternate array definition */
+		case TT_OHAIIM:
+			ret = parseAltArrayDefStmtNode(tokenp);
+			break;
+		/* Bare expression */
+		default:
+			ret = parseExprStmtNode(tokenp);
+			if (!ret) parser_error(PR_EXPECTED_STATEMENT, tokens);
+			break;
 	}
 
-#ifdef DEBUG
 	shiftin();
-#endif
 
 	return ret;
 }
 
+/**
+ * Flags the token types that terminate a code block.  parseBlockNode() reads
+ * the current token's type once per statement and indexes this table instead
+ * of peeking at the stream once for each terminator in turn.
+ */
+static const unsigned char blockTerminators[TT_ENDOFTOKENS + 1] = {
+	[TT_EOF] = 1,
+	[TT_KTHXBYE] = 1,
+	[TT_OIC] = 1,
+	[TT_YARLY] = 1,
+	[TT_NOWAI] = 1,
+	[TT_MEBBE] = 1,
+	[TT_OMG] = 1,
+	[TT_OMGWTF] = 1,
+	[TT_IMOUTTAYR] = 1,
+	[TT_IFUSAYSO] = 1,
+	[TT_KTHX] = 1,
+};
+
 /**
  * Parses tokens into a code block.
  *
+ * \note This recurses mutually with parseStmtNode() for statements that
+ * contain nested blocks, so the C stack usage is proportional to the block
+ * nesting depth of the program, not to its length.
+ *
  * \param [in] tokenp The position in a token list to start parsing at.
  *
  * \post \a tokenp will point to the next unparsed token.
@@ -4072,26 +3863,14 @@ BlockNode *parseBlockNode(Token ***tokenp)
 	/* Work from a copy of the token stream in case something goes wrong */
 	Token **tokens = *tokenp;
 
-#ifdef DEBUG
 	shiftout();
 	debug(">ET_BLOCK");
-#endif
 
 	/* Create a list of statements */
 	stmts = createStmtNodeList();
 	if (!stmts) goto parseBlockNodeAbort;
-	/* Parse block until certain tokens are found */
-	while (!peekToken(&tokens, TT_EOF)
-			&& !peekToken(&tokens, TT_KTHXBYE)
-			&& !peekToken(&tokens, TT_OIC)
-			&& !peekToken(&tokens, TT_YARLY)
-			&& !peekToken(&tokens, TT_NOWAI)
-			&& !peekToken(&tokens, TT_MEBBE)
-			&& !peekToken(&tokens, TT_OMG)
-			&& !peekToken(&tokens, TT_OMGWTF)
-			&& !peekToken(&tokens, TT_IMOUTTAYR)
-			&& !peekToken(&tokens, TT_IFUSAYSO)
-			&& !peekToken(&tokens, TT_KTHX)) {
+	/* Parse block until a terminator token is found */
+	while (!blockTerminators[(*tokens)->type]) {
 		/* Parse the next statement */
 		stmt = parseStmtNode(&tokens);
 		if (!stmt) goto parseBlockNodeAbort;
@@ -4102,10 +3881,8 @@ BlockNode *parseBlockNode(Token ***tokenp)
 		stmt = NULL;
 	}
 
-#ifdef DEBUG
 	debug("<ET_BLOCK");
 	shiftin();
-#endif
 
 	/* Create the BlockNode structure */
 	block = createBlockNode(stmts);
@@ -4130,6 +3907,11 @@ parseBlockNodeAbort: /* Exception handling */
 /**
  * Parses tokens into a main code block.
  *
+ * \note This is a single pass over the token stream: function definitions
+ * are parsed in place by parseStmtNode() as they are encountered and bound
+ * to names at interpretation time, so no separate prototype discovery pass
+ * is required.
+ *
  * \param [in] tokens The position in a token list to start parsing at.
  *
  * \post \a tokenp will point to the next unparsed token.
@@ -4142,39 +3924,26 @@ MainNode *parseMainNode(Token **tokens)
 {
 	BlockNode *block = NULL;
 	MainNode *_main = NULL;
-	int status;
 
 	/* All programs must start with the HAI token */
-	status = acceptToken(&tokens, TT_HAI);
-	if (!status) {
-		parser_error_expected_token(TT_HAI, tokens);
-		goto parseMainNodeAbort;
-	}
+	EXPECT_TOKEN(TT_HAI, parseMainNodeAbort);
 
-	/* Accept any version */
-	tokens++;
+	/* Accept any version, but never step past the end-of-file sentinel;
+	 * the token helpers rely on the cursor always pointing at a valid
+	 * token */
+	if ((*tokens)->type != TT_EOF) tokens++;
 
-#ifdef DEBUG
 	debug("ET_MAINBLOCK");
-#endif
 
 	/* Make sure the header line ends with a newline */
-	status = acceptToken(&tokens, TT_NEWLINE);
-	if (!status) {
-		parser_error(PR_EXPECTED_END_OF_STATEMENT, tokens);
-		goto parseMainNodeAbort;
-	}
+	EXPECT_TOKEN_ERROR(TT_NEWLINE, PR_EXPECTED_END_OF_STATEMENT, parseMainNodeAbort);
 
 	/* Parse the main block of code */
 	block = parseBlockNode(&tokens);
 	if (!block) goto parseMainNodeAbort;
 
 	/* Make sure the program ends with KTHXBYE */
-	status = acceptToken(&tokens, TT_KTHXBYE);
-	if (!status) {
-		parser_error_expected_token(TT_KTHXBYE, tokens);
-		goto parseMainNodeAbort;
-	}
+	EXPECT_TOKEN(TT_KTHXBYE, parseMainNodeAbort);
 
 	/* Create the MainBlockNode structure */
 	_main = createMainNode(block);
@@ -4184,9 +3953,8 @@ MainNode *parseMainNode(Token **tokens)
 
 parseMainNodeAbort: /* In case something goes wrong... */
 
-	/* Clean up any allocated structures */
-	if (_main) deleteMainNode(_main);
-	else if (block) deleteBlockNode(block);
+	/* Clean up; everything parsed so far lives in the arena */
+	deleteArena();
 
 	return NULL;
 }
@@ -204,6 +204,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <float.h>
@@ -245,6 +246,7 @@ typedef struct {
  */
 typedef struct {
 	unsigned int num; /**< The number of statements. */
+	unsigned int cap; /**< The number of allocated slots. */
 	StmtNode **stmts; /**< The array of statements. */
 } StmtNodeList;
 
@@ -261,19 +263,69 @@ typedef enum {
 } ExprType;
 
 /**
- * Stores an expression.
+ * Stores an expression.  The expression data pointer and the expression type
+ * are packed into a single word: expression data is always at least 8-byte
+ * aligned (the parser's arena aligns every allocation), leaving the low
+ * three bits of the pointer free to hold the type tag.  Use getExprType(),
+ * getExprData(), and setExprNode() to access the fields.
+ *
+ * The data deliberately stays behind the tagged pointer rather than being
+ * embedded as a union: a union would grow every expression to the size of
+ * its largest member, while this representation keeps an ExprNode to one
+ * word and the sub-node a single bump allocation away.
  */
 typedef struct {
-	ExprType type; /**< The type of expression in \a expr. */
-	void *expr;    /**< The expression. */ 
+	uintptr_t ref; /**< The expression data pointer tagged with its type. */
 } ExprNode;
 
+/**
+ * Returns the type of an expression.
+ *
+ * \param [in] node The expression to get the type of.
+ *
+ * \return The type of expression in \a node.
+ */
+static inline ExprType getExprType(const ExprNode *node)
+{
+	return (ExprType)(node->ref & 7);
+}
+
+/**
+ * Returns the data of an expression.
+ *
+ * \param [in] node The expression to get the data of.
+ *
+ * \return The expression data stored in \a node.
+ */
+static inline void *getExprData(const ExprNode *node)
+{
+	return (void *)(node->ref & ~(uintptr_t)7);
+}
+
+/**
+ * Sets the type and data of an expression.
+ *
+ * \param [in,out] node The expression to set up.
+ *
+ * \param [in] type The type of expression in \a expr.
+ *
+ * \param [in] expr The expression data (must be 8-byte aligned).
+ */
+static inline void setExprNode(ExprNode *node,
+                               ExprType type,
+                               void *expr)
+{
+	node->ref = (uintptr_t)expr | (uintptr_t)type;
+}
+
 /**
  * Stores a list of expressions.
  */
 typedef struct {
-	unsigned int num; /**< The number of expressions. */
-	ExprNode **exprs; /**< The array of statements. */
+	unsigned int num;     /**< The number of expressions. */
+	unsigned int cap;     /**< The number of allocated slots. */
+	ExprNode **exprs;     /**< The array of statements. */
+	ExprNode *inline_[4]; /**< Inline storage for short lists. */
 } ExprNodeList;
 
 /**
@@ -300,6 +352,7 @@ typedef struct identifiernode {
  */
 typedef struct {
 	unsigned int num;     /**< The number of identifiers. */
+	unsigned int cap;     /**< The number of allocated slots. */
 	IdentifierNode **ids; /**< The array of identifiers. */
 } IdentifierNodeList;
 
@@ -315,6 +368,7 @@ typedef struct {
  */
 typedef struct {
 	unsigned int num;   /**< The number of code blocks. */
+	unsigned int cap;   /**< The number of allocated slots. */
 	BlockNode **blocks; /**< The array of code blocks. */
 } BlockNodeList;
 
@@ -388,7 +442,7 @@ typedef struct {
  */
 typedef struct {
 	IdentifierNode *target; /**< The name of the variable to cast. */
-	TypeNode *newtype;      /**< The type to cast \a target to. */
+	TypeNode newtype;       /**< The type to cast \a target to. */
 } CastStmtNode;
 
 /**
@@ -469,13 +523,14 @@ typedef struct {
 
 /**
  * Stores a loop statement.  This statement repeatedly executes its \a body
- * while \a guard evaluates to true, executing \a update at the end of each
- * cycle.
+ * while \a guard evaluates to true (or, if \a invert is set, to false),
+ * executing \a update at the end of each cycle.
  */
 typedef struct {
 	IdentifierNode *name; /**< The name of the loop. */
 	IdentifierNode *var;  /**< The variable to be updated. */
 	ExprNode *guard;      /**< The expression to determine continuation. */
+	int invert;           /**< Whether to invert \a guard (a TIL loop). */
 	ExprNode *update;     /**< The expression to update \a var with. */
 	BlockNode *body;      /**< The code to execute at each iteration. */
 } LoopStmtNode;
@@ -493,8 +548,8 @@ typedef struct {
  * its value to a particular type.
  */
 typedef struct {
-	ExprNode *target;  /**< The expression to cast. */
-	TypeNode *newtype; /**< The type to cast \a target to. */
+	ExprNode *target; /**< The expression to cast. */
+	TypeNode newtype; /**< The type to cast \a target to. */
 } CastExprNode;
 
 /**
@@ -685,7 +740,7 @@ void deleteReturnStmtNode(ReturnStmtNode *);
  * Functions for creating and deleting LoopStmtNodes.
  */
 /**@{*/
-LoopStmtNode *createLoopStmtNode(IdentifierNode *, IdentifierNode *, ExprNode *, ExprNode *, BlockNode *);
+LoopStmtNode *createLoopStmtNode(IdentifierNode *, IdentifierNode *, ExprNode *, int, ExprNode *, BlockNode *);
 void deleteLoopStmtNode(LoopStmtNode *);
 /**@}*/
 
@@ -765,12 +820,80 @@ void deleteOpExprNode(OpExprNode *);
 /**
  * \name Utilities
  *
- * Functions for performing helper tasks.
+ * Functions for performing helper tasks.  These are defined here as \c static
+ * \c inline because they sit on every parsing path and are small enough for
+ * the compiler to fold into their callers.
  */
 /**@{*/
-int acceptToken(Token ***, TokenType);
-int peekToken(Token ***, TokenType);
-int nextToken(Token ***, TokenType);
+/**
+ * Checks if a type of token is at a position in a token list, and if so,
+ * advances the position.
+ *
+ * \param [in,out] tokenp The position in a token list to check.
+ *
+ * \param [in] token The type of token to check for.
+ *
+ * \pre The token list ends with a \c TT_EOF sentinel and the position never
+ * advances past it, so \a tokenp always points at a valid token.
+ *
+ * \post If the type of \a tokenp is not \a token, \a tokenp will remain
+ * unchanged, else, it will point to the token after the one matched.
+ *
+ * \retval 0 The type of \a tokenp is \a token.
+ *
+ * \retval 1 The type of \a tokenp is not \a token.
+ */
+static inline int acceptToken(Token ***tokenp,
+                              TokenType token)
+{
+	Token **tokens = *tokenp;
+	if ((*tokens)->type != token) return 0;
+	tokens++;
+	*tokenp = tokens;
+	return 1;
+}
+
+/**
+ * Checks if a type of token is at a position in a token list.
+ *
+ * \param [in] tokenp The position in a token list to check.
+ *
+ * \param [in] token The type of token to check for.
+ *
+ * \post \a tokenp will remain unchanged.
+ *
+ * \retval 0 The type of \a tokenp is \a token.
+ *
+ * \retval 1 The type of \a tokenp is not \a token.
+ */
+static inline int peekToken(Token ***tokenp,
+                            TokenType token)
+{
+	Token **tokens = *tokenp;
+	if ((*tokens)->type != token) return 0;
+	return 1;
+}
+
+/**
+ * Checks if a type of token is after a position in a token list.
+ *
+ * \param [in] tokenp The position in a token list to check after.
+ *
+ * \param [in] token The type of token to check for.
+ *
+ * \post \a tokenp will remain unchanged.
+ *
+ * \retval 0 The type of the token after \a tokenp is \a token.
+ *
+ * \retval 1 The type of the token after \a tokenp is not \a token.
+ */
+static inline int nextToken(Token ***tokenp,
+                            TokenType token)
+{
+	Token **tokens = *tokenp;
+	if ((*(tokens + 1))->type != token) return 0;
+	return 1;
+}
 /**@}*/
 
 /**
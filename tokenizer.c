@@ -1,24 +1,319 @@
 #include "tokenizer.h"
 
+/**
+ * Stores a pool of interned strings.  The pool is an open-addressed hash set
+ * (with linear probing) which stores exactly one copy of every string added
+ * to it.  Interning a string twice yields the same pointer both times, so
+ * interned strings may be compared for equality by comparing pointers.
+ */
+typedef struct {
+	char **strings;   /**< The hash set of interned strings. */
+	unsigned int num; /**< The number of interned strings. */
+	unsigned int cap; /**< The number of slots in \a strings. */
+} StringPool;
+
+/**
+ * The pool of interned token images.  One pool is shared by all of the
+ * tokens generated from a single call to tokenizeLexemes and is freed along
+ * with them by deleteTokens.  The string storage itself lives in the image
+ * arena (below); the pool only tracks the canonical copies.
+ */
+static StringPool pool = { NULL, 0, 0 };
+
+/** The number of tokens in each token slab. */
+#define TOKEN_SLAB_SIZE 512
+
+/**
+ * Stores a slab of tokens.  Token structures are carved out of contiguous
+ * slabs rather than allocated one malloc at a time, so consecutive tokens sit
+ * next to each other in memory and the whole lot can be released at once by
+ * deleteTokens.
+ */
+typedef struct tokenslab {
+	struct tokenslab *next;        /**< The previously filled slab. */
+	unsigned int used;             /**< The number of tokens carved out. */
+	Token tokens[TOKEN_SLAB_SIZE]; /**< The token storage. */
+} TokenSlab;
+
+/** The current (most recently allocated) token slab. */
+static TokenSlab *tokenSlabs = NULL;
+
+/**
+ * Allocates a token from the token slabs.
+ *
+ * \return A pointer to a new uninitialized token.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static Token *allocToken(void)
+{
+	if (!tokenSlabs || tokenSlabs->used == TOKEN_SLAB_SIZE) {
+		TokenSlab *slab = malloc(sizeof(TokenSlab));
+		if (!slab) {
+			perror("malloc");
+			return NULL;
+		}
+		slab->next = tokenSlabs;
+		slab->used = 0;
+		tokenSlabs = slab;
+	}
+	return &tokenSlabs->tokens[tokenSlabs->used++];
+}
+
+/**
+ * Deletes all of the token slabs.
+ *
+ * \post The memory at the token slabs and all of the tokens within them will
+ * be freed.
+ */
+static void deleteTokenSlabs(void)
+{
+	while (tokenSlabs) {
+		TokenSlab *next = tokenSlabs->next;
+		free(tokenSlabs);
+		tokenSlabs = next;
+	}
+}
+
+/** The default number of usable bytes in an image arena chunk. */
+#define IMAGE_ARENA_SIZE 8192
+
+/**
+ * Stores a chunk of token image memory.  Non-identifier token images are
+ * bump-allocated out of a singly linked list of chunks instead of costing
+ * one malloc each, and the chunks are freed all at once by deleteTokens.
+ */
+typedef struct imagechunk {
+	struct imagechunk *next; /**< The previously filled chunk. */
+	size_t off;              /**< The offset of the first free byte. */
+	size_t cap;              /**< The number of usable bytes. */
+} ImageChunk;
+
+/** The current (most recently allocated) image arena chunk. */
+static ImageChunk *imageArena = NULL;
+
+/**
+ * Copies a string into the image arena.
+ *
+ * \param [in] image The string to copy.
+ *
+ * \return A pointer to an arena-owned copy of \a image.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static char *imageArenaStrdup(const char *image)
+{
+	size_t len = strlen(image) + 1;
+	char *p;
+	if (!imageArena || imageArena->cap - imageArena->off < len) {
+		size_t cap = len > IMAGE_ARENA_SIZE ? len : IMAGE_ARENA_SIZE;
+		ImageChunk *chunk = malloc(sizeof(ImageChunk) + cap);
+		if (!chunk) {
+			perror("malloc");
+			return NULL;
+		}
+		chunk->next = imageArena;
+		chunk->off = 0;
+		chunk->cap = cap;
+		imageArena = chunk;
+	}
+	p = (char *)(imageArena + 1) + imageArena->off;
+	memcpy(p, image, len);
+	imageArena->off += len;
+	return p;
+}
+
+/**
+ * Deletes the image arena.
+ *
+ * \post The memory at the image arena and all of the images within it will
+ * be freed.
+ */
+static void deleteImageArena(void)
+{
+	while (imageArena) {
+		ImageChunk *next = imageArena->next;
+		free(imageArena);
+		imageArena = next;
+	}
+}
+
+/**
+ * Hashes a string using the FNV-1a hash function.
+ *
+ * \param [in] image The string to hash.
+ *
+ * \return The hash of \a image.
+ */
+static unsigned int hashString(const char *image)
+{
+	unsigned int hash = 2166136261u;
+	while (*image) {
+		hash ^= (unsigned char)*image++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Grows a string pool to a new capacity and rehashes its contents.
+ *
+ * \param [in,out] p The string pool to grow.
+ *
+ * \param [in] newcap The new number of slots (must be a power of two).
+ *
+ * \retval 0 Memory allocation failed.
+ *
+ * \retval 1 \a p now has \a newcap slots.
+ */
+static int growStringPool(StringPool *p, unsigned int newcap)
+{
+	char **strings = calloc(newcap, sizeof(char *));
+	unsigned int n;
+	if (!strings) {
+		perror("calloc");
+		return 0;
+	}
+	for (n = 0; n < p->cap; n++) {
+		unsigned int slot;
+		if (!p->strings[n]) continue;
+		slot = hashString(p->strings[n]) & (newcap - 1);
+		while (strings[slot]) slot = (slot + 1) & (newcap - 1);
+		strings[slot] = p->strings[n];
+	}
+	free(p->strings);
+	p->strings = strings;
+	p->cap = newcap;
+	return 1;
+}
+
+/**
+ * Interns a string.  If an equal string was interned before, the previously
+ * stored copy is returned, otherwise a new copy is added to the pool.
+ *
+ * \param [in] image The string to intern.
+ *
+ * \return The canonical copy of \a image, owned by the pool.
+ *
+ * \retval NULL Memory allocation failed.
+ */
+static char *internString(const char *image)
+{
+	unsigned int slot;
+	char *copy = NULL;
+	/* Keep the pool at most half full */
+	if (pool.num * 2 >= pool.cap) {
+		if (!growStringPool(&pool, pool.cap ? pool.cap * 2 : 256))
+			return NULL;
+	}
+	slot = hashString(image) & (pool.cap - 1);
+	while (pool.strings[slot]) {
+		if (!strcmp(pool.strings[slot], image))
+			return pool.strings[slot];
+		slot = (slot + 1) & (pool.cap - 1);
+	}
+	copy = imageArenaStrdup(image);
+	if (!copy) return NULL;
+	pool.strings[slot] = copy;
+	pool.num++;
+	return copy;
+}
+
+/**
+ * Deletes the string pool.
+ *
+ * \post The pool is empty.  The interned strings themselves belong to the
+ * image arena and are freed with it.
+ */
+static void deleteStringPool(void)
+{
+	free(pool.strings);
+	pool.strings = NULL;
+	pool.num = 0;
+	pool.cap = 0;
+}
+
+/**
+ * Checks if a character is a decimal digit.  The ctype.h classifiers go
+ * through a locale table behind a thread-local pointer; the LOLCODE grammar
+ * is ASCII-only, so a direct range check is equivalent and cheaper.
+ *
+ * \param [in] c The character to check.
+ *
+ * \retval 0 \a c is not a decimal digit.
+ *
+ * \retval 1 \a c is a decimal digit.
+ */
+static int asciiDigit(int c)
+{
+	return (unsigned int)(c - '0') < 10u;
+}
+
+/**
+ * Checks if a character is an ASCII letter.
+ *
+ * \param [in] c The character to check.
+ *
+ * \retval 0 \a c is not a letter.
+ *
+ * \retval 1 \a c is a letter.
+ */
+static int asciiAlpha(int c)
+{
+	return (unsigned int)((c | 32) - 'a') < 26u;
+}
+
+/**
+ * Counts the decimal digits at the start of a string.  Full eight-byte
+ * chunks are classified in parallel: with the ASCII digit values folded down
+ * to 0-9 by the XOR, adding 0x76 to each byte sets its high bit exactly when
+ * the byte was not a digit, and the OR with the original chunk also flags
+ * non-ASCII bytes.  Any flagged chunk (and the tail shorter than eight
+ * bytes) falls back to the byte-at-a-time scan.
+ *
+ * \param [in] image The string to scan.
+ *
+ * \param [in] len The length of \a image.
+ *
+ * \return The number of leading digit characters in \a image.
+ */
+static size_t digitSpan(const char *image, size_t len)
+{
+	size_t n = 0;
+	while (len - n >= 8) {
+		uint64_t chunk;
+		memcpy(&chunk, image + n, sizeof(chunk));
+		if ((chunk | ((chunk ^ 0x3030303030303030ULL)
+				+ 0x7676767676767676ULL))
+				& 0x8080808080808080ULL)
+			break;
+		n += 8;
+	}
+	while (n < len && asciiDigit((unsigned char)image[n])) n++;
+	return n;
+}
+
 /**
  * Checks if a string follows the format for an integer.  Specifically, it
  * checks if the string matches the regular expression: (-?[1-9][0-9]*|0).
  *
  * \param [in] image The string to check.
  *
+ * \param [in] len The length of \a image.
+ *
  * \retval 0 \a image does not match the pattern for an integer.
  *
  * \retval 1 \a image matches the pattern for an integer.
  */
-int isInteger(const char *image)
+int isInteger(const char *image, size_t len)
 {
 	const char *cur = image;
 	if (*cur == '-'
-			|| (isdigit(*cur) && *cur != '0')
-			|| (*cur == '0' && *(cur + 1) == '\0')) {
+			|| (asciiDigit(*cur) && *cur != '0')
+			|| (*cur == '0' && len == 1)) {
 		cur++;
-		while (isdigit(*cur)) cur++;
-		if (*cur == '\0') return 1;
+		len--;
+		if (digitSpan(cur, len) == len) return 1;
 	}
 	return 0;
 }
@@ -29,19 +324,21 @@ int isInteger(const char *image)
  *
  * \param [in] image The string to check.
  *
+ * \param [in] len The length of \a image.
+ *
  * \retval 0 \a image does not match the pattern for a decimal.
  *
  * \retval 1 \a image matches the pattern for a decimal.
  */
-int isFloat(const char *image)
+int isFloat(const char *image, size_t len)
 {
 	const char *cur = image;
-	if (*cur == '-' || isdigit(*cur)) {
+	if (*cur == '-' || asciiDigit(*cur)) {
 		cur++;
-		while (isdigit(*cur)) cur++;
+		cur += digitSpan(cur, len - (cur - image));
 		if (*cur == '.') {
 			cur++;
-			while (isdigit(*cur)) cur++;
+			cur += digitSpan(cur, len - (cur - image));
 			if (*cur == '\0') return 1;
 		}
 	}
@@ -54,13 +351,14 @@ int isFloat(const char *image)
  *
  * \param [in] image The string to check.
  *
+ * \param [in] len The length of \a image.
+ *
  * \retval 0 \a image does not match the pattern for a string.
  *
  * \retval 1 \a image matches the pattern for a string.
  */
-int isString(const char *image)
+int isString(const char *image, size_t len)
 {
-	size_t len = strlen(image);
 	return (len >= 2 && image[0] == '"' && image[len - 1] == '"');
 }
 
@@ -70,19 +368,21 @@ int isString(const char *image)
  *
  * \param image [in] The string to check.
  *
+ * \param len [in] The length of \a image.
+ *
  * \retval 0 \a image does not match the pattern for an identifier.
  *
  * \retval 1 \a image matches the pattern for an identifier.
  */
-int isIdentifier(const char *image)
+int isIdentifier(const char *image, size_t len)
 {
-	const char *cur = image;
+	size_t n;
 	/* First character must be alphabetic */
-	if (!cur || !isalpha(*cur)) return 0;
-	cur++;
-	while (*cur) {
-		if (isalnum(*cur) || *cur == '_') cur++;
-		else return 0;
+	if (!image || !asciiAlpha(*image)) return 0;
+	for (n = 1; n < len; n++) {
+		if (!asciiAlpha(image[n]) && !asciiDigit(image[n])
+				&& image[n] != '_')
+			return 0;
 	}
 	return 1;
 }
@@ -107,19 +407,16 @@ Token *createToken(TokenType type,
                    const char *fname,
                    unsigned int line)
 {
-	Token *ret = malloc(sizeof(Token));
-	if (!ret) {
-		perror("malloc");
-		return NULL;
-	}
+	Token *ret = allocToken();
+	if (!ret) return NULL;
 	ret->type = type;
-	ret->image = malloc(sizeof(char) * (strlen(image) + 1));
+	/* Identifier and keyword images repeat often; share one interned
+	 * copy per distinct image instead of storing each occurrence */
+	ret->image = internString(image);
 	if (!(ret->image)) {
-		free(ret);
-		perror("malloc");
+		tokenSlabs->used--;
 		return NULL;
 	}
-	strcpy(ret->image, image);
 	/**
 	 * \note fname is not copied because only one copy is stored for all
 	 * Token structures that share it.
@@ -134,13 +431,13 @@ Token *createToken(TokenType type,
  *
  * \param [in,out] token The token to delete.
  *
- * \post The memory at \a token and all of its members will be freed.
+ * \post Nothing is freed: the Token structure belongs to a token slab and its
+ * image to the string pool or the image arena, all of which are freed when
+ * deleteTokens() is called.
  */
 void deleteToken(Token *token)
 {
-	if (!token) return;
-	free(token->image);
-	free(token);
+	(void)token;
 }
 
 /**
@@ -150,10 +447,13 @@ void deleteToken(Token *token)
  *
  * \param [in,out] num The number of tokens in \a list.
  *
+ * \param [in,out] cap The number of allocated slots in \a list.
+ *
  * \param [in] token The token to add to \a list.
  *
  * \post \a token will be added to the end of \a list and the size of \a list
- * will be updated.
+ * will be updated, growing the list geometrically when it is full so that
+ * the total reallocation work stays linear in the number of tokens.
  *
  * \retval 0 Memory allocation failed.
  *
@@ -161,17 +461,21 @@ void deleteToken(Token *token)
  */
 int addToken(Token ***list,
              unsigned int *num,
+             unsigned int *cap,
              Token *token)
 {
-	unsigned int newsize = *num + 1;
-	void *mem = realloc(*list, sizeof(Token *) * newsize);
-	if (!mem) {
-		perror("realloc");
-		return 0;
+	if (*num == *cap) {
+		unsigned int newcap = *cap ? *cap * 2 : 64;
+		void *mem = realloc(*list, sizeof(Token *) * newcap);
+		if (!mem) {
+			perror("realloc");
+			return 0;
+		}
+		*list = mem;
+		*cap = newcap;
 	}
-	*list = mem;
 	(*list)[*num] = token;
-	*num = newsize;
+	(*num)++;
 #ifdef DEBUG
 	fprintf(stderr, "Adding token type %d [%s]\n", token->type, token->image);
 #endif
@@ -187,46 +491,166 @@ int addToken(Token ***list,
  */
 void deleteTokens(Token **list)
 {
-	Token **tok = list;
-	while (*tok) {
-		deleteToken(*tok);
-		tok++;
-	}
+	/* The tokens live in the slabs and their images in the string pool
+	 * and image arena, so there is no need to visit each token; the
+	 * backing allocations are simply released wholesale */
 	free(list);
+	deleteStringPool();
+	deleteTokenSlabs();
+	deleteImageArena();
 }
 
+/** The largest number of space-delimited words in any keyword. */
+#define KW_MAX_WORDS 4
+
+/**
+ * Stores the precomputed word layout of a keyword.  The offsets and lengths
+ * of the words within the keyword image never change, so they are measured
+ * once when the keyword index is built instead of being rediscovered by
+ * rescanning the image for spaces on every match attempt.
+ */
+typedef struct {
+	unsigned char words;                  /**< The number of words. */
+	unsigned char wordoff[KW_MAX_WORDS];  /**< The offset of each word. */
+	unsigned char wordlen[KW_MAX_WORDS];  /**< The length of each word. */
+	/** Each word of at most eight characters, zero-padded into a single
+	 * integer so it can be matched with one compare. */
+	uint64_t wordbits[KW_MAX_WORDS];
+} KwInfo;
+
+/** The word layout of each keyword, indexed by TokenType. */
+static KwInfo kwInfo[TT_ENDOFTOKENS];
+
 /**
  * Matches lexemes against a string.  Traverses \a lexemes starting at \a start
- * and compares lexeme images to space-delimited substrings from \a match.
+ * and compares lexeme images to the space-delimited words of the keyword for
+ * \a type.
  *
  * \param lexemes [in] The list of lexemes to match from.
  *
  * \param start [in] The index within \a lexemes to start matching at.
- * 
- * \param match [in] A string of space-delimited substrings to match.
+ *
+ * \param type [in] The type of the keyword to match against.
  *
  * \return The number of lexemes matched.
  */
 unsigned int acceptLexemes(LexemeList *lexemes,
                            unsigned int start,
-                           const char *match)
+                           TokenType type)
 {
-	unsigned int offset = 0;
-	unsigned int n;
-	unsigned int i;
-	for (n = 0, i = 0;
-			match[n] || lexemes->lexemes[start + offset]->image[i];
-			n++) {
-		if (match[n] == ' ') {
-			offset++;
-			i = 0;
-			continue;
+	const char *match = keywords[type];
+	const KwInfo *info = &kwInfo[type];
+	unsigned int word;
+	for (word = 0; word < info->words; word++) {
+		Lexeme *lexeme = lexemes->lexemes[start + word];
+		/* Compare a whole word of the keyword at once; the lengths
+		 * and offsets were precomputed when the index was built */
+		if (lexeme->len != info->wordlen[word]) return 0;
+		if (info->wordlen[word] <= sizeof(uint64_t)) {
+			/* Short words were packed into an integer when the
+			 * index was built; one compare settles the word */
+			uint64_t bits = 0;
+			memcpy(&bits, lexeme->image, info->wordlen[word]);
+			if (bits != info->wordbits[word]) return 0;
 		}
-		if (lexemes->lexemes[start + offset]->image[i] != match[n])
+		else if (memcmp(lexeme->image, match + info->wordoff[word],
+				info->wordlen[word]))
 			return 0;
-		i++;
 	}
-	return offset + 1;
+	return info->words;
+}
+
+/**
+ * The number of slots in the keyword index (a power of two, comfortably
+ * larger than the number of distinct keyword first words).
+ */
+#define KW_INDEX_SIZE 256
+
+/**
+ * The head of each keyword index bucket: the first candidate TokenType whose
+ * keyword's first word hashes to the slot, or -1 for an empty bucket.
+ * Candidates within a bucket are chained through \ref kwIndexNext in
+ * ascending TokenType order, which preserves the match priority of the old
+ * linear scan over \c keywords.
+ */
+static short kwIndexHead[KW_INDEX_SIZE];
+
+/** The next candidate TokenType in the same bucket, or -1 at the end. */
+static short kwIndexNext[TT_ENDOFTOKENS];
+
+/**
+ * Whether any keyword starts with a given character.  Most lexemes are
+ * identifiers or numbers that no keyword could match, so this rejects them
+ * with a single table load before the first word is even hashed.
+ */
+static unsigned char kwFirstChar[256];
+
+/** Whether the keyword index has been built yet. */
+static int kwIndexReady = 0;
+
+/**
+ * Hashes the first space-delimited word of a string using the FNV-1a hash
+ * function.
+ *
+ * \param [in] image The string whose first word to hash.
+ *
+ * \return The hash of the first word of \a image.
+ */
+static unsigned int hashKeywordWord(const char *image)
+{
+	unsigned int hash = 2166136261u;
+	while (*image && *image != ' ') {
+		hash ^= (unsigned char)*image++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Builds the keyword index.  Every keyword is appended to the bucket its
+ * first word hashes to; because types are visited in ascending order, each
+ * bucket lists its candidates in the same order the old linear scan checked
+ * them.  Hash collisions between different first words merely add candidates
+ * to a bucket, which is harmless: every candidate is verified in full by
+ * acceptLexemes() before it is accepted.
+ */
+static void buildKeywordIndex(void)
+{
+	short tail[KW_INDEX_SIZE];
+	unsigned int n;
+	short type;
+	for (n = 0; n < KW_INDEX_SIZE; n++) {
+		kwIndexHead[n] = -1;
+		tail[n] = -1;
+	}
+	for (type = 0; type != TT_ENDOFTOKENS; type++) {
+		const char *image = keywords[type];
+		unsigned int slot;
+		unsigned int pos = 0;
+		kwIndexNext[type] = -1;
+		kwInfo[type].words = 0;
+		/* Some token types have no keyword */
+		if (!keywords[type][0]) continue;
+		/* Record where each word of the keyword starts and ends */
+		while (image[pos]) {
+			unsigned int wordlen = strcspn(image + pos, " ");
+			unsigned char word = kwInfo[type].words++;
+			kwInfo[type].wordoff[word] = pos;
+			kwInfo[type].wordlen[word] = wordlen;
+			kwInfo[type].wordbits[word] = 0;
+			if (wordlen <= sizeof(uint64_t))
+				memcpy(&kwInfo[type].wordbits[word],
+						image + pos, wordlen);
+			pos += wordlen;
+			if (image[pos] == ' ') pos++;
+		}
+		slot = hashKeywordWord(keywords[type]) & (KW_INDEX_SIZE - 1);
+		if (tail[slot] < 0) kwIndexHead[slot] = type;
+		else kwIndexNext[tail[slot]] = type;
+		tail[slot] = type;
+		kwFirstChar[(unsigned char)keywords[type][0]] = 1;
+	}
+	kwIndexReady = 1;
 }
 
 /**
@@ -252,14 +676,19 @@ Token *isKeyword(LexemeList *lexemes,
                  unsigned int *start)
 {
 	Token *token = NULL;
-	TokenType type;
+	const char *image = lexemes->lexemes[*start]->image;
 	const char *fname = lexemes->lexemes[*start]->fname;
 	unsigned int line = lexemes->lexemes[*start]->line;
-	/* For each keyword, */
-	for (type = 0; type != TT_ENDOFTOKENS; type++) {
+	short type;
+	if (!kwIndexReady) buildKeywordIndex();
+	/* Reject lexemes that no keyword could match before hashing */
+	if (!kwFirstChar[(unsigned char)image[0]]) return NULL;
+	/* For each keyword whose first word may match the current lexeme, */
+	for (type = kwIndexHead[hashKeywordWord(image) & (KW_INDEX_SIZE - 1)];
+			type >= 0;
+			type = kwIndexNext[type]) {
 		/* Check if the start of lexemes match */
-		unsigned int num = acceptLexemes(lexemes,
-				*start, keywords[type]);
+		unsigned int num = acceptLexemes(lexemes, *start, type);
 		if (!num) continue;
 		/* If so, create a new token for the keyword */
 		token = createToken(type, keywords[type], fname, line);
@@ -270,6 +699,65 @@ Token *isKeyword(LexemeList *lexemes,
 	return token;
 }
 
+/**
+ * Classifies a word lexeme in a single left-to-right pass.  The predicates
+ * isString, isFloat, isInteger and isIdentifier each restart from the
+ * beginning of the image, so a lexeme could be scanned several times before
+ * its class was known; this routine is the same set of patterns fused into
+ * one deterministic scan that reads each character once.
+ *
+ * \param [in] image The lexeme image to classify.
+ *
+ * \param [in] len The length of \a image.
+ *
+ * \return The type of literal that \a image matches.
+ *
+ * \retval TT_ENDOFTOKENS \a image matches no literal form (though it may
+ * still be a keyword).
+ */
+static TokenType classifyWord(const char *image, size_t len)
+{
+	size_t n;
+	/* String: (".*") */
+	if (image[0] == '"')
+		return isString(image, len) ? TT_STRING : TT_ENDOFTOKENS;
+	/* Numeric: a digit run, then either the end (integer) or a decimal
+	 * point and another digit run (float) */
+	if (image[0] == '-' || asciiDigit(image[0])) {
+		size_t digits;
+		n = (image[0] == '-') ? 1 : 0;
+		digits = digitSpan(image + n, len - n);
+		n += digits;
+		if (n == len) {
+			/* Require at least one digit and reject a leading
+			 * zero unless it is the whole number */
+			if (digits && (image[0] != '0' || len == 1))
+				return TT_INTEGER;
+			return TT_ENDOFTOKENS;
+		}
+		if (image[n] == '.') {
+			size_t frac;
+			n++;
+			frac = digitSpan(image + n, len - n);
+			n += frac;
+			/* At least one digit must appear on one side of the
+			 * decimal point */
+			if (n == len && digits + frac > 0) return TT_FLOAT;
+		}
+		return TT_ENDOFTOKENS;
+	}
+	/* Identifier: ([a-zA-Z][a-zA-Z0-9_]*) */
+	if (asciiAlpha(image[0])) {
+		for (n = 1; n < len; n++) {
+			if (!asciiAlpha(image[n]) && !asciiDigit(image[n])
+					&& image[n] != '_')
+				return TT_ENDOFTOKENS;
+		}
+		return TT_IDENTIFIER;
+	}
+	return TT_ENDOFTOKENS;
+}
+
 /**
  * Converts a list of lexemes into tokens.  Also parses integers, floats, and
  * strings into tokens with semantic meaning.
@@ -283,86 +771,104 @@ Token *isKeyword(LexemeList *lexemes,
  */
 Token **tokenizeLexemes(LexemeList *list)
 {
-	void *mem = NULL;
 	Token **ret = NULL;
 	unsigned int retsize = 0;
+	unsigned int num = list->num;
+	Lexeme **lexemes = list->lexemes;
 	unsigned int n;
-	for (n = 0; n < list->num; n++) {
-		Lexeme *lexeme = list->lexemes[n];
+	/* Starting as if a newline was just emitted makes the duplicate
+	 * check below swallow any initial newlines too */
+	TokenType lasttype = TT_NEWLINE;
+
+	/* Each lexeme produces at most one token, so allocating room for
+	 * them all plus the terminator up front means the array never has
+	 * to grow */
+	ret = malloc(sizeof(Token *) * (num + 1));
+	if (!ret) {
+		perror("malloc");
+		return NULL;
+	}
+	for (n = 0; n < num; n++) {
+		Lexeme *lexeme = lexemes[n];
 		const char *image = lexeme->image;
+		size_t len = lexeme->len;
 		const char *fname = lexeme->fname;
 		unsigned int line = lexeme->line;
 		Token *token = NULL;
-		/* String */
-		if (isString(image)) {
-			token = createToken(TT_STRING, image, fname, line);
-		}
-		/* Float */
-		else if (isFloat(image)) {
-			token = createToken(TT_FLOAT, image, fname, line);
-			if (sscanf(lexeme->image, "%f", &(token->data.f)) != 1)
-				error(TK_EXPECTED_FLOATING_POINT, fname, line);
-		}
-		/* Integer */
-		else if (isInteger(image)) {
-			token = createToken(TT_INTEGER, image, fname, line);
-			if (sscanf(lexeme->image, "%lli", &(token->data.i)) != 1)
-				error(TK_EXPECTED_INTEGER, fname, line);
-		}
-		/* FAIL */
-		else if (!strcmp(image, "FAIL")) {
-			token = createToken(TT_BOOLEAN, "FAIL", fname, line);
-			token->data.i = 0;
-		}
-		/* WIN */
-		else if (!strcmp(image, "WIN")) {
-			token = createToken(TT_BOOLEAN, "WIN", fname, line);
-			token->data.i = 1;
-		}
-		/* CAN HAS STDIO? */
-		else if (n < list->num - 2
-				&& !strcmp(lexeme->image, "CAN")
-				&& !strcmp(list->lexemes[n + 1]->image, "HAS")
-				&& !strcmp(list->lexemes[n + 2]->image, "STDIO?")) {
-			n += 2;
-			/* Just for fun; not actually in spec */
-			continue;
-		}
 		/* Newline */
 		/* Note that the spec is unclear as to whether a command *must*
 		 * follow a comma.  For now, we let commas end a line. */
-		else if (!strcmp(image, "\n")) {
-			/* Note that we ignore any initial newlines */
-			if (retsize < 1) {
-#ifdef DEBUG
-				fprintf(stderr, "Skipping initial newline.\n");
-#endif
-				continue;
-			}
-			else if (ret[retsize - 1]->type == TT_NEWLINE) {
+		if (lexeme->kind == LK_NEWLINE) {
+			/* Note that we ignore any initial or duplicate
+			 * newlines */
+			if (lasttype == TT_NEWLINE) {
 #ifdef DEBUG
 				fprintf(stderr, "Skipping duplicate newline.\n");
 #endif
 				continue;
 			}
-			else {
-				token = createToken(TT_NEWLINE, "end of line", fname, line);
-			}
-		}
-		/* Keyword */
-		else if ((token = isKeyword(list, &n))) {
-		}
-		/* Identifier */
-		/* This must be placed after keyword parsing or else most
-		 * keywords would be tokenized as identifiers. */
-		else if (isIdentifier(image)) {
-			token = createToken(TT_IDENTIFIER, image, fname, line);
+			token = createToken(TT_NEWLINE, "end of line", fname, line);
 		}
 		/* EOF */
-		else if (!strcmp(image, "$")) {
+		else if (lexeme->kind == LK_EOF) {
 			token = createToken(TT_EOF, "end of file", fname, line);
 		}
 		else {
+			/* One fused scan settles which literal form, if any,
+			 * the word matches */
+			TokenType wordtype = classifyWord(image, len);
+			/* String */
+			if (wordtype == TT_STRING) {
+				token = createToken(TT_STRING, image, fname, line);
+			}
+			/* Float */
+			else if (wordtype == TT_FLOAT) {
+				token = createToken(TT_FLOAT, image, fname, line);
+				/* classifyWord already validated the image */
+				token->data.f = strtof(image, NULL);
+			}
+			/* Integer */
+			else if (wordtype == TT_INTEGER) {
+				token = createToken(TT_INTEGER, image, fname, line);
+				/* classifyWord already validated the image;
+				 * strtoll still avoids sscanf's format-string
+				 * machinery and clamps out-of-range literals
+				 * to LLONG_MAX/LLONG_MIN as sscanf did */
+				token->data.i = strtoll(image, NULL, 10);
+			}
+			/* FAIL */
+			else if (!strcmp(image, "FAIL")) {
+				token = createToken(TT_BOOLEAN, "FAIL", fname, line);
+				token->data.i = 0;
+			}
+			/* WIN */
+			else if (!strcmp(image, "WIN")) {
+				token = createToken(TT_BOOLEAN, "WIN", fname, line);
+				token->data.i = 1;
+			}
+			/* CAN HAS STDIO? */
+			/* The two-character guard skips the three-lexeme
+			 * compare for everything not starting with "CA" */
+			else if (image[0] == 'C' && image[1] == 'A'
+					&& n < num - 2
+					&& !strcmp(lexeme->image, "CAN")
+					&& !strcmp(lexemes[n + 1]->image, "HAS")
+					&& !strcmp(lexemes[n + 2]->image, "STDIO?")) {
+				n += 2;
+				/* Just for fun; not actually in spec */
+				continue;
+			}
+			/* Keyword */
+			else if ((token = isKeyword(list, &n))) {
+			}
+			/* Identifier */
+			/* This must be placed after keyword parsing or else
+			 * most keywords would be tokenized as identifiers. */
+			else if (wordtype == TT_IDENTIFIER) {
+				token = createToken(TT_IDENTIFIER, image, fname, line);
+			}
+		}
+		if (!token) {
 			error(TK_UNKNOWN_TOKEN, fname, line, image);
 			/* Clean up */
 			deleteToken(ret[retsize - 1]);
@@ -371,24 +877,17 @@ Token **tokenizeLexemes(LexemeList *list)
 			return NULL;
 		}
 
-		/* Add the token to the token array */
-		if (!addToken(&ret, &retsize, token)) {
-			/* Clean up */
-			if (token) deleteToken(token);
-			deleteToken(ret[retsize - 1]);
-			ret[retsize - 1] = NULL;
-			deleteTokens(ret);
-			return NULL;
-		}
-	}
-	mem = realloc(ret, sizeof(Token *) * ++retsize);
-	if (!mem) {
-		deleteToken(ret[retsize - 2]);
-		ret[retsize - 2] = NULL;
-		deleteTokens(ret);
-		return NULL;
+		/* Add the token to the token array; the capacity was sized
+		 * for one token per lexeme up front, so the array can never
+		 * be full here */
+		ret[retsize++] = token;
+#ifdef DEBUG
+		fprintf(stderr, "Adding token type %d [%s]\n", token->type,
+				token->image);
+#endif
+		lasttype = token->type;
 	}
-	ret = mem;
-	ret[retsize - 1] = NULL;
+	/* The terminator slot is reserved by the initial capacity */
+	ret[retsize] = NULL;
 	return ret;
 }
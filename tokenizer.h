@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "lexer.h"
 #include "error.h"
@@ -213,10 +214,10 @@ typedef struct {
  * Functions for performing helper tasks.
  */
 /**@{*/
-int isInteger(const char *);
-int isFloat(const char *);
-int isString(const char *);
-int isIdentifier(const char *);
+int isInteger(const char *, size_t);
+int isFloat(const char *, size_t);
+int isString(const char *, size_t);
+int isIdentifier(const char *, size_t);
 Token *isKeyword(LexemeList *, unsigned int *);
 /**@}*/
 
@@ -228,9 +229,9 @@ Token *isKeyword(LexemeList *, unsigned int *);
 /**@{*/
 Token *createToken(TokenType, const char *, const char *, unsigned int);
 void deleteToken(Token *);
-int addToken(Token ***, unsigned int *, Token*);
+int addToken(Token ***, unsigned int *, unsigned int *, Token*);
 void deleteTokens(Token **);
-unsigned int acceptLexemes(LexemeList *, unsigned int, const char *);
+unsigned int acceptLexemes(LexemeList *, unsigned int, TokenType);
 /**@}*/
 
 /**